@@ -0,0 +1,190 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "WorkStealingExecutor.h"
+#include <algorithm>
+
+namespace
+{
+    // executor and deque index of the current thread, when it is a worker
+    thread_local Trinity::WorkStealingExecutor const* CurrentExecutor = nullptr;
+    thread_local std::size_t CurrentWorkerIndex = 0;
+
+    constexpr std::size_t InitialDequeCapacity = 64;
+}
+
+void Trinity::WorkStealingExecutor::JobDeque::PushBack(ExecutorJob&& job)
+{
+    if (_size == _jobs.size())
+        Grow();
+
+    _jobs[(_head + _size) % _jobs.size()] = std::move(job);
+    ++_size;
+}
+
+Trinity::ExecutorJob Trinity::WorkStealingExecutor::JobDeque::PopFront()
+{
+    ExecutorJob job = std::move(_jobs[_head]);
+    _head = (_head + 1) % _jobs.size();
+    --_size;
+    return job;
+}
+
+Trinity::ExecutorJob Trinity::WorkStealingExecutor::JobDeque::PopBack()
+{
+    --_size;
+    return std::move(_jobs[(_head + _size) % _jobs.size()]);
+}
+
+void Trinity::WorkStealingExecutor::JobDeque::Grow()
+{
+    // storage is only ever grown, a deque that absorbed a burst keeps its capacity
+    std::vector<ExecutorJob> jobs(std::max(InitialDequeCapacity, _jobs.size() * 2));
+    for (std::size_t i = 0; i < _size; ++i)
+        jobs[i] = std::move(_jobs[(_head + i) % _jobs.size()]);
+
+    _jobs.swap(jobs);
+    _head = 0;
+}
+
+Trinity::WorkStealingExecutor::WorkStealingExecutor(std::size_t numThreads) : _pendingJobs(0), _nextQueue(0), _stopping(false)
+{
+    if (!numThreads)
+        numThreads = 1;
+
+    _queues.reserve(numThreads);
+    for (std::size_t i = 0; i < numThreads; ++i)
+        _queues.push_back(std::make_unique<WorkerQueue>());
+
+    _workers.reserve(numThreads);
+    for (std::size_t i = 0; i < numThreads; ++i)
+        _workers.emplace_back(&WorkStealingExecutor::WorkerThread, this, i);
+}
+
+Trinity::WorkStealingExecutor::~WorkStealingExecutor()
+{
+    Join();
+}
+
+void Trinity::WorkStealingExecutor::Post(ExecutorJob&& job, TaskPriority priority /*= TaskPriority::Normal*/)
+{
+    std::size_t index = IsWorkerThread() ? CurrentWorkerIndex : _nextQueue.fetch_add(1, std::memory_order_relaxed) % _queues.size();
+
+    // counted before it becomes visible so takers never drive the counter below zero
+    _pendingJobs.fetch_add(1);
+
+    {
+        WorkerQueue& queue = *_queues[index];
+        std::lock_guard<std::mutex> lock(queue.Lock);
+        queue.Jobs[std::size_t(priority)].PushBack(std::move(job));
+    }
+
+    // pass through the sleep lock so a worker about to wait cannot miss the new job
+    { std::lock_guard<std::mutex> lock(_sleepLock); }
+    _sleepCondition.notify_one();
+}
+
+bool Trinity::WorkStealingExecutor::RunPendingJob(TaskPriority lowestPriority /*= TaskPriority::Normal*/)
+{
+    ExecutorJob job;
+    if (!TryTake(IsWorkerThread() ? CurrentWorkerIndex : 0, lowestPriority, job))
+        return false;
+
+    job();
+    return true;
+}
+
+void Trinity::WorkStealingExecutor::Join()
+{
+    if (_workers.empty())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(_sleepLock);
+        _stopping = true;
+    }
+    _sleepCondition.notify_all();
+
+    for (std::thread& worker : _workers)
+        worker.join();
+
+    _workers.clear();
+}
+
+bool Trinity::WorkStealingExecutor::IsWorkerThread() const
+{
+    return CurrentExecutor == this;
+}
+
+bool Trinity::WorkStealingExecutor::TryTake(std::size_t index, TaskPriority lowestPriority, ExecutorJob& job)
+{
+    if (!_pendingJobs.load())
+        return false;
+
+    for (std::size_t priority = 0; priority <= std::size_t(lowestPriority); ++priority)
+    {
+        // own deque first, oldest job first
+        {
+            WorkerQueue& queue = *_queues[index];
+            std::lock_guard<std::mutex> lock(queue.Lock);
+            if (!queue.Jobs[priority].Empty())
+            {
+                job = queue.Jobs[priority].PopFront();
+                _pendingJobs.fetch_sub(1);
+                return true;
+            }
+        }
+
+        // then steal the newest job of another worker
+        for (std::size_t i = 1; i < _queues.size(); ++i)
+        {
+            WorkerQueue& queue = *_queues[(index + i) % _queues.size()];
+            std::lock_guard<std::mutex> lock(queue.Lock);
+            if (!queue.Jobs[priority].Empty())
+            {
+                job = queue.Jobs[priority].PopBack();
+                _pendingJobs.fetch_sub(1);
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+void Trinity::WorkStealingExecutor::WorkerThread(std::size_t index)
+{
+    CurrentExecutor = this;
+    CurrentWorkerIndex = index;
+
+    while (true)
+    {
+        ExecutorJob job;
+        if (TryTake(index, TaskPriority::Low, job))
+        {
+            job();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(_sleepLock);
+        _sleepCondition.wait(lock, [this] { return _pendingJobs.load() > 0 || _stopping; });
+
+        // drain everything queued before stopping
+        if (_stopping && !_pendingJobs.load())
+            return;
+    }
+}
@@ -0,0 +1,200 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRINITY_WORK_STEALING_EXECUTOR_H
+#define TRINITY_WORK_STEALING_EXECUTOR_H
+
+#include "Define.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Trinity
+{
+enum class TaskPriority : uint8
+{
+    High    = 0,
+    Normal  = 1,
+    Low     = 2                 // background work, only ever run by the workers themselves
+};
+
+constexpr std::size_t MAX_TASK_PRIORITY = 3;
+
+// Move only callable with inline storage, submitting a job never allocates
+class ExecutorJob
+{
+public:
+    static constexpr std::size_t StorageSize = 64;
+
+    ExecutorJob() noexcept : _ops(nullptr) { }
+
+    template<typename F, typename Fn = std::decay_t<F>, std::enable_if_t<!std::is_same_v<Fn, ExecutorJob>, int> = 0>
+    ExecutorJob(F&& function) : _ops(&OpsFor<Fn>)
+    {
+        static_assert(sizeof(Fn) <= StorageSize, "Job is too large to be stored inline, capture a pointer instead");
+        static_assert(alignof(Fn) <= alignof(std::max_align_t), "Job alignment is not supported");
+        static_assert(std::is_nothrow_move_constructible_v<Fn>, "Job must be nothrow move constructible");
+        new (&_storage) Fn(std::forward<F>(function));
+    }
+
+    ExecutorJob(ExecutorJob&& other) noexcept : _ops(other._ops)
+    {
+        if (_ops)
+        {
+            _ops->Move(&_storage, &other._storage);
+            other._ops = nullptr;
+        }
+    }
+
+    ExecutorJob& operator=(ExecutorJob&& other) noexcept
+    {
+        if (this != &other)
+        {
+            Reset();
+            _ops = other._ops;
+            if (_ops)
+            {
+                _ops->Move(&_storage, &other._storage);
+                other._ops = nullptr;
+            }
+        }
+        return *this;
+    }
+
+    ExecutorJob(ExecutorJob const&) = delete;
+    ExecutorJob& operator=(ExecutorJob const&) = delete;
+
+    ~ExecutorJob() { Reset(); }
+
+    explicit operator bool() const { return _ops != nullptr; }
+
+    void operator()() { _ops->Invoke(&_storage); }
+
+    void Reset()
+    {
+        if (_ops)
+        {
+            _ops->Destroy(&_storage);
+            _ops = nullptr;
+        }
+    }
+
+private:
+    struct Operations
+    {
+        void(*Invoke)(void* storage);
+        void(*Move)(void* destination, void* source);
+        void(*Destroy)(void* storage);
+    };
+
+    template<typename Fn>
+    static constexpr Operations OpsFor =
+    {
+        [](void* storage) { (*static_cast<Fn*>(storage))(); },
+        [](void* destination, void* source) { new (destination) Fn(std::move(*static_cast<Fn*>(source))); static_cast<Fn*>(source)->~Fn(); },
+        [](void* storage) { static_cast<Fn*>(storage)->~Fn(); }
+    };
+
+    alignas(std::max_align_t) unsigned char _storage[StorageSize];
+    Operations const* _ops;
+};
+
+/*
+    Fixed size pool of workers, each owning one deque per priority.
+    Workers take jobs from the front of their own deques and steal from the back of the others,
+    jobs posted from outside the pool are spread round robin over all workers.
+    Higher priority jobs are always looked for first, in every deque.
+*/
+class TC_COMMON_API WorkStealingExecutor
+{
+public:
+    explicit WorkStealingExecutor(std::size_t numThreads);
+    ~WorkStealingExecutor();
+
+    WorkStealingExecutor(WorkStealingExecutor const&) = delete;
+    WorkStealingExecutor& operator=(WorkStealingExecutor const&) = delete;
+
+    void Post(ExecutorJob&& job, TaskPriority priority = TaskPriority::Normal);
+
+    // Runs one queued job of at least the given priority on the calling thread, returns false if there was none
+    bool RunPendingJob(TaskPriority lowestPriority = TaskPriority::Normal);
+
+    // Keeps the calling thread busy with queued jobs until done() is true, use it instead of blocking
+    // when waiting on jobs from inside a job or the pool could run out of workers
+    template<typename Predicate>
+    void HelpUntil(Predicate&& done, TaskPriority lowestPriority = TaskPriority::Normal)
+    {
+        while (!done())
+            if (!RunPendingJob(lowestPriority))
+                std::this_thread::yield();
+    }
+
+    // Finishes all queued jobs and stops the workers
+    void Join();
+
+    std::size_t GetThreadCount() const { return _workers.size(); }
+    bool IsWorkerThread() const;
+
+private:
+    class JobDeque
+    {
+    public:
+        JobDeque() : _head(0), _size(0) { }
+
+        bool Empty() const { return _size == 0; }
+
+        void PushBack(ExecutorJob&& job);
+        ExecutorJob PopFront();
+        ExecutorJob PopBack();
+
+    private:
+        void Grow();
+
+        std::vector<ExecutorJob> _jobs;
+        std::size_t _head;
+        std::size_t _size;
+    };
+
+    struct WorkerQueue
+    {
+        std::mutex Lock;
+        JobDeque Jobs[MAX_TASK_PRIORITY];
+    };
+
+    void WorkerThread(std::size_t index);
+    bool TryTake(std::size_t index, TaskPriority lowestPriority, ExecutorJob& job);
+
+    std::vector<std::unique_ptr<WorkerQueue>> _queues;
+    std::vector<std::thread> _workers;
+
+    std::atomic<std::size_t> _pendingJobs;
+    std::atomic<std::size_t> _nextQueue;
+    std::atomic<bool> _stopping;
+
+    std::mutex _sleepLock;
+    std::condition_variable _sleepCondition;
+};
+}
+
+#endif // TRINITY_WORK_STEALING_EXECUTOR_H
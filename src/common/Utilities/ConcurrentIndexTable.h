@@ -0,0 +1,97 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _CONCURRENT_INDEX_TABLE_H_
+#define _CONCURRENT_INDEX_TABLE_H_
+
+#include "Define.h"
+#include <array>
+#include <atomic>
+#include <memory>
+
+namespace Trinity
+{
+    /**
+    * Pointers indexed by a 32 bit counter, meant for dense ids like player guid counters.
+    * Reads are wait free: two acquire loads, no lock and no retry.
+    * Storage is a radix table of chunks allocated on first write and only released
+    * with the table, so a reader never sees memory go away under it.
+    * Writers to different indexes may run concurrently, writers to one index must be serialized by the caller.
+    */
+    template<typename T, uint32 ChunkBits = 16>
+    class ConcurrentIndexTable
+    {
+        // the top level holds 2^(32 - ChunkBits) chunk pointers
+        static_assert(ChunkBits >= 12 && ChunkBits < 32);
+
+        static constexpr std::size_t ChunkSize = std::size_t(1) << ChunkBits;
+        static constexpr std::size_t ChunkCount = (std::size_t(1) << 32) >> ChunkBits;
+
+        struct Chunk
+        {
+            std::array<std::atomic<T*>, ChunkSize> Slots = { };
+        };
+
+    public:
+        ConcurrentIndexTable() : _chunks(std::make_unique<std::atomic<Chunk*>[]>(ChunkCount)) { }
+
+        ~ConcurrentIndexTable()
+        {
+            for (std::size_t i = 0; i < ChunkCount; ++i)
+                delete _chunks[i].load(std::memory_order_relaxed);
+        }
+
+        ConcurrentIndexTable(ConcurrentIndexTable const&) = delete;
+        ConcurrentIndexTable& operator=(ConcurrentIndexTable const&) = delete;
+
+        T* Find(uint32 index) const
+        {
+            Chunk const* chunk = _chunks[index >> ChunkBits].load(std::memory_order_acquire);
+            if (!chunk)
+                return nullptr;
+
+            return chunk->Slots[index & (ChunkSize - 1)].load(std::memory_order_acquire);
+        }
+
+        void Set(uint32 index, T* value)
+        {
+            std::atomic<Chunk*>& slot = _chunks[index >> ChunkBits];
+            Chunk* chunk = slot.load(std::memory_order_acquire);
+            if (!chunk)
+            {
+                if (!value)
+                    return;
+
+                // racing writers of the same chunk keep whichever was published first
+                Chunk* created = new Chunk();
+                if (slot.compare_exchange_strong(chunk, created, std::memory_order_acq_rel, std::memory_order_acquire))
+                    chunk = created;
+                else
+                    delete created;
+            }
+
+            chunk->Slots[index & (ChunkSize - 1)].store(value, std::memory_order_release);
+        }
+
+        void Clear(uint32 index) { Set(index, nullptr); }
+
+    private:
+        std::unique_ptr<std::atomic<Chunk*>[]> _chunks;
+    };
+}
+
+#endif // _CONCURRENT_INDEX_TABLE_H_
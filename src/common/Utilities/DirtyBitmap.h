@@ -0,0 +1,109 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _DIRTY_BITMAP_H_
+#define _DIRTY_BITMAP_H_
+
+#include "Define.h"
+#include <algorithm>
+#include <bit>
+#include <vector>
+
+namespace Trinity
+{
+    /**
+    * Fixed size bitmap for change tracking, packed in 64 bit words.
+    * The words holding set bits are also kept in a sorted list, so visiting the set bits
+    * and clearing only touch those words instead of the whole bitmap.
+    */
+    class DirtyBitmap
+    {
+    public:
+        static constexpr uint32 BitsPerWord = 64;
+
+        DirtyBitmap() : _bitCount(0) { }
+
+        void Resize(uint32 bitCount)
+        {
+            _words.assign((bitCount + BitsPerWord - 1) / BitsPerWord, 0);
+            _dirtyWords.clear();
+            _bitCount = bitCount;
+        }
+
+        uint32 GetBitCount() const { return _bitCount; }
+
+        void Set(uint32 index)
+        {
+            uint64& word = _words[index / BitsPerWord];
+            if (!word)
+                _dirtyWords.insert(std::upper_bound(_dirtyWords.begin(), _dirtyWords.end(), index / BitsPerWord), index / BitsPerWord);
+
+            word |= GetWordFlag(index);
+        }
+
+        void Reset(uint32 index)
+        {
+            uint64& word = _words[index / BitsPerWord];
+            if (!word)
+                return;
+
+            word &= ~GetWordFlag(index);
+            if (!word)
+                _dirtyWords.erase(std::lower_bound(_dirtyWords.begin(), _dirtyWords.end(), index / BitsPerWord));
+        }
+
+        bool Test(uint32 index) const { return (_words[index / BitsPerWord] & GetWordFlag(index)) != 0; }
+
+        bool Any() const { return !_dirtyWords.empty(); }
+
+        void Clear()
+        {
+            for (uint32 wordIndex : _dirtyWords)
+                _words[wordIndex] = 0;
+
+            _dirtyWords.clear();
+        }
+
+        // Calls visitor with every set bit below limit in ascending order, the bitmap must not be modified meanwhile
+        template<typename Visitor>
+        void ForEachSetBit(Visitor&& visitor, uint32 limit = 0xFFFFFFFF) const
+        {
+            for (uint32 wordIndex : _dirtyWords)
+            {
+                uint64 word = _words[wordIndex];
+                while (word)
+                {
+                    uint32 index = wordIndex * BitsPerWord + std::countr_zero(word);
+                    if (index >= limit)
+                        return;
+
+                    visitor(index);
+                    word &= word - 1;
+                }
+            }
+        }
+
+    private:
+        static constexpr uint64 GetWordFlag(uint32 index) { return uint64(1) << (index % BitsPerWord); }
+
+        std::vector<uint64> _words;
+        std::vector<uint32> _dirtyWords;
+        uint32 _bitCount;
+    };
+}
+
+#endif // _DIRTY_BITMAP_H_
@@ -0,0 +1,94 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _REUSABLE_BUFFER_H_
+#define _REUSABLE_BUFFER_H_
+
+#include "Define.h"
+#include <boost/container/small_vector.hpp>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace Trinity
+{
+    /**
+    * Vector leased from a per thread pool for the lifetime of this object.
+    * Released vectors are cleared but keep their storage, so the next lease on the same
+    * thread does not allocate unless it needs more room than any lease before it.
+    * Leases nest, each live one owns a distinct vector.
+    * Meant for short lived results such as grid searches, never keep a reference past the lease.
+    */
+    template<typename T, std::size_t InlineCapacity = 16>
+    class ReusableBuffer
+    {
+    public:
+        using Container = boost::container::small_vector<T, InlineCapacity>;
+
+        // vectors that grew beyond this are freed instead of pinning their memory to the thread
+        static constexpr std::size_t MaxRetainedCapacity = 1024;
+        // deepest nesting of leases kept around
+        static constexpr std::size_t MaxPooled = 8;
+
+        ReusableBuffer() : _container(Acquire()) { }
+        ~ReusableBuffer() { Release(std::move(_container)); }
+
+        ReusableBuffer(ReusableBuffer const&) = delete;
+        ReusableBuffer(ReusableBuffer&&) = delete;
+        ReusableBuffer& operator=(ReusableBuffer const&) = delete;
+        ReusableBuffer& operator=(ReusableBuffer&&) = delete;
+
+        Container& operator*() { return *_container; }
+        Container const& operator*() const { return *_container; }
+        Container* operator->() { return _container.get(); }
+        Container const* operator->() const { return _container.get(); }
+
+    private:
+        using Pool = std::vector<std::unique_ptr<Container>>;
+
+        static Pool& GetPool()
+        {
+            thread_local Pool pool;
+            return pool;
+        }
+
+        static std::unique_ptr<Container> Acquire()
+        {
+            Pool& pool = GetPool();
+            if (pool.empty())
+                return std::make_unique<Container>();
+
+            std::unique_ptr<Container> container = std::move(pool.back());
+            pool.pop_back();
+            return container;
+        }
+
+        static void Release(std::unique_ptr<Container> container)
+        {
+            Pool& pool = GetPool();
+            if (container->capacity() > MaxRetainedCapacity || pool.size() >= MaxPooled)
+                return;
+
+            container->clear();
+            pool.push_back(std::move(container));
+        }
+
+        std::unique_ptr<Container> _container;
+    };
+}
+
+#endif // _REUSABLE_BUFFER_H_
@@ -0,0 +1,77 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _SKIPPED_UPDATES_H_
+#define _SKIPPED_UPDATES_H_
+
+#include "Define.h"
+#include <algorithm>
+
+namespace Trinity
+{
+    /**
+    * Lets an object skip all but one of every period visits, keeping the skipped time for its next update.
+    * Visits are counted per object instead of comparing with a global tick, so objects only visited on
+    * some ticks (staggered cells) still update once per period of their own visits.
+    * The phase spreads objects sharing a period over different visits.
+    */
+    class SkippedUpdates
+    {
+    public:
+        SkippedUpdates() : _skippedTime(0), _period(0), _visitsUntilUpdate(0) { }
+
+        // true when this visit is skipped and diff was kept
+        bool Skip(uint32 phase, uint32 period, uint32 diff)
+        {
+            if (period <= 1)
+                return false;
+
+            // the countdown starts from the phase on the first visit and is never pushed back by a period
+            // change, creatures moving between near and far cells would otherwise restart it over and over
+            if (_period != period)
+            {
+                _visitsUntilUpdate = _period ? std::min(_visitsUntilUpdate, period - 1) : phase % period;
+                _period = period;
+            }
+
+            if (!_visitsUntilUpdate)
+                return false;
+
+            --_visitsUntilUpdate;
+            _skippedTime += diff;
+            return true;
+        }
+
+        // diff of the update done on this visit, with the time of the skipped visits
+        uint32 Take(uint32 diff)
+        {
+            diff += _skippedTime;
+            _skippedTime = 0;
+            _visitsUntilUpdate = _period ? _period - 1 : 0;
+            return diff;
+        }
+
+        uint32 GetSkippedTime() const { return _skippedTime; }
+
+    private:
+        uint32 _skippedTime;
+        uint32 _period;
+        uint32 _visitsUntilUpdate;
+    };
+}
+
+#endif // _SKIPPED_UPDATES_H_
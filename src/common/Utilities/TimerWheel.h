@@ -0,0 +1,107 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _TIMER_WHEEL_H_
+#define _TIMER_WHEEL_H_
+
+#include "Define.h"
+#include <algorithm>
+#include <array>
+#include <utility>
+#include <vector>
+
+/**
+* Hashed timer wheel.
+* Timers are kept in a ring of slots, each slot covering one resolution step, so
+* scheduling is constant time and advancing only looks at the slots that were passed.
+* Timers further away than one full turn carry the number of turns left to wait.
+* There is no cancel, owners are expected to ignore timers that became stale.
+*/
+template<typename T, std::size_t Slots = 256>
+class TimerWheel
+{
+    struct Timer
+    {
+        uint32 Turns;
+        T Value;
+    };
+
+public:
+    explicit TimerWheel(uint32 resolution) : _resolution(resolution ? resolution : 1), _cursor(0), _elapsed(0), _size(0) { }
+
+    /**
+    * @name Schedule
+    * @brief Schedules value to expire after delay, rounded up to the wheel resolution.
+    * @param delay Time in ms.
+    */
+    void Schedule(uint32 delay, T value)
+    {
+        uint32 steps = std::max<uint32>(1, (delay + _resolution - 1) / _resolution);
+        _slots[(_cursor + steps) % Slots].push_back({ (steps - 1) / uint32(Slots), std::move(value) });
+        ++_size;
+    }
+
+    /**
+    * @name Advance
+    * @brief Moves the wheel forward and calls expired(T&) for every timer that is due.
+    * @param diff Time in ms since the last call.
+    */
+    template<typename Callback>
+    void Advance(uint32 diff, Callback&& expired)
+    {
+        _elapsed += diff;
+        while (_elapsed >= _resolution)
+        {
+            _elapsed -= _resolution;
+            _cursor = (_cursor + 1) % Slots;
+
+            std::vector<Timer>& slot = _slots[_cursor];
+            for (std::size_t i = 0; i < slot.size();)
+            {
+                if (slot[i].Turns)
+                {
+                    --slot[i].Turns;
+                    ++i;
+                    continue;
+                }
+
+                _expired.push_back(std::move(slot[i].Value));
+                slot[i] = std::move(slot.back());
+                slot.pop_back();
+                --_size;
+            }
+
+            // callbacks are free to schedule again, even into the slot that was just processed
+            for (T& value : _expired)
+                expired(value);
+            _expired.clear();
+        }
+    }
+
+    std::size_t Size() const { return _size; }
+    bool Empty() const { return _size == 0; }
+
+private:
+    std::array<std::vector<Timer>, Slots> _slots;
+    std::vector<T> _expired;
+    uint32 _resolution;
+    std::size_t _cursor;
+    uint32 _elapsed;
+    std::size_t _size;
+};
+
+#endif // _TIMER_WHEEL_H_
@@ -646,7 +646,7 @@ Battleground* BattlegroundMgr::CreateNewBattleground(BattlegroundTypeId original
     bool isRandom = bgTypeId != originalBgTypeId && !bg->isArena();
 
     bg->SetBracket(bracketEntry);
-    bg->SetInstanceID(sMapMgr->GenerateInstanceId());
+    bg->SetInstanceID(sMapMgr->AssignBattlegroundInstanceId(bg));
     bg->SetClientInstanceID(CreateClientVisibleInstanceId(originalBgTypeId, bracketEntry->GetBracketId()));
     bg->Reset();                     // reset the new bg (set status to status_wait_queue from status_none)
     bg->SetStatus(STATUS_WAIT_JOIN); // start the joining of the bg
@@ -18,6 +18,7 @@
 #include "Creature.h"
 #include "BattlegroundMgr.h"
 #include "CellImpl.h"
+#include "CellSpatialIndex.h"
 #include "Common.h"
 #include "Containers.h"
 #include "CreatureAI.h"
@@ -47,6 +48,7 @@
 #include "PoolMgr.h"
 #include "QueryPackets.h"
 #include "QuestDef.h"
+#include "ReusableBuffer.h"
 #include "ScriptedGossip.h"
 #include "SpellAuraEffects.h"
 #include "SpellMgr.h"
@@ -277,7 +279,7 @@ m_respawnDelay(300), m_corpseDelay(60), m_wanderDistance(0.0f), m_boundaryCheckT
 m_defaultMovementType(IDLE_MOTION_TYPE), m_spawnId(0), m_equipmentId(0), m_originalEquipmentId(0), m_AlreadyCallAssistance(false),
 m_AlreadySearchedAssistance(false), m_regenHealth(true), m_cannotReachTarget(false), m_cannotReachTimer(0), m_meleeDamageSchoolMask(SPELL_SCHOOL_MASK_NORMAL),
 m_originalEntry(0), m_homePosition(), m_transportHomePosition(), m_creatureInfo(nullptr), m_creatureData(nullptr), _waypointPathId(0), _currentWaypointNodeInfo(0, 0), _cyclicSplinePathId(0),
-m_formation(nullptr), m_triggerJustAppeared(true), m_respawnCompatibilityMode(false), _lastDamagedTime(0), _isMissingSwimmingFlagOutOfCombat(false), _noNpcDamageBelowPctHealth(0.f)
+m_formation(nullptr), m_triggerJustAppeared(true), m_respawnCompatibilityMode(false), _farFromPlayers(false), _lastDamagedTime(0), _isMissingSwimmingFlagOutOfCombat(false), _noNpcDamageBelowPctHealth(0.f)
 {
     m_valuesCount = UNIT_END;
 
@@ -2334,20 +2336,17 @@ void Creature::CallAssistance()
 
         if (radius > 0)
         {
-            std::list<Creature*> assistList;
+            Trinity::ReusableBuffer<Creature*> assistList;
             Trinity::AnyAssistCreatureInRangeCheck u_check(this, GetVictim(), radius);
-            Trinity::CreatureListSearcher<Trinity::AnyAssistCreatureInRangeCheck> searcher(this, assistList, u_check);
+            Trinity::CreatureListSearcher<Trinity::AnyAssistCreatureInRangeCheck> searcher(this, *assistList, u_check);
             Cell::VisitGridObjects(this, searcher, radius);
 
-            if (!assistList.empty())
+            if (!assistList->empty())
             {
                 AssistDelayEvent* e = new AssistDelayEvent(EnsureVictim()->GetGUID(), *this);
-                while (!assistList.empty())
-                {
-                    // Pushing guids because in delay can happen some creature gets despawned => invalid pointer
-                    e->AddAssistant((*assistList.begin())->GetGUID());
-                    assistList.pop_front();
-                }
+                // Pushing guids because in delay can happen some creature gets despawned => invalid pointer
+                for (Creature* assistant : *assistList)
+                    e->AddAssistant(assistant->GetGUID());
                 m_Events.AddEvent(e, m_Events.CalculateTime(sWorld->getIntConfig(CONFIG_CREATURE_FAMILY_ASSISTANCE_DELAY)));
             }
         }
@@ -2800,6 +2799,22 @@ std::string Creature::GetScriptName() const
     return sObjectMgr->GetScriptName(GetScriptId());
 }
 
+bool Creature::CanSkipUpdates() const
+{
+    // anything a player could notice being late stays on every tick
+    if (IsInCombat() || IsEngaged() || m_triggerJustAppeared || !movespline->Finalized() || HasUnitState(UNIT_STATE_CASTING | UNIT_STATE_EVADE))
+        return false;
+
+    if (IsSummon() || IsVehicle() || IsCharmed() || !GetOwnerGUID().IsEmpty() || IsTrigger())
+        return false;
+
+    // scripted creatures, template and spawn data are checked directly since GetScriptId and GetAIName look them up again
+    if (!m_creatureInfo->AIName.empty() || m_creatureInfo->ScriptID || (m_creatureData && m_creatureData->scriptId))
+        return false;
+
+    return true;
+}
+
 uint32 Creature::GetScriptId() const
 {
     if (CreatureData const* creatureData = GetCreatureData())
@@ -3026,6 +3041,7 @@ void Creature::SetObjectScale(float scale)
     {
         SetFloatValue(UNIT_FIELD_BOUNDINGRADIUS, (IsPet() ? 1.0f : minfo->bounding_radius) * scale);
         SetFloatValue(UNIT_FIELD_COMBATREACH, (IsPet() ? DEFAULT_PLAYER_COMBAT_REACH : minfo->combat_reach) * scale);
+        CellSpatialIndex::Update(this);
     }
 }
 
@@ -3037,6 +3053,7 @@ void Creature::SetDisplayId(uint32 modelId, bool setNative /*= false*/)
     {
         SetFloatValue(UNIT_FIELD_BOUNDINGRADIUS, (IsPet() ? 1.0f : minfo->bounding_radius) * GetObjectScale());
         SetFloatValue(UNIT_FIELD_COMBATREACH, (IsPet() ? DEFAULT_PLAYER_COMBAT_REACH : minfo->combat_reach) * GetObjectScale());
+        CellSpatialIndex::Update(this);
     }
 }
 
@@ -25,6 +25,7 @@
 #include "Duration.h"
 #include "Loot.h"
 #include "MapObject.h"
+#include "SkippedUpdates.h"
 
 #include <list>
 
@@ -406,6 +407,15 @@ class TC_GAME_API Creature : public Unit, public GridObject<Creature>, public Ma
 
         void ForcePartyMembersIntoCombat();
 
+        // Bucketed updates, idle creatures may skip visits of their cell and get the skipped time on their next update
+        bool CanSkipUpdates() const;
+        bool SkipUpdate(uint32 period, uint32 diff) { return _skippedUpdates.Skip(GetGUID().GetCounter(), period, diff); }
+        uint32 TakeSkippedUpdateTime(uint32 diff) { return _skippedUpdates.Take(diff); }
+
+        // Outside the full update range of every player, updated less often and not wandering around
+        bool IsFarFromPlayers() const { return _farFromPlayers; }
+        void SetFarFromPlayers(bool farFromPlayers) { _farFromPlayers = farFromPlayers; }
+
         bool HasStaticFlag(CreatureStaticFlags flag) const { return _staticFlags.HasFlag(flag); }
         bool HasStaticFlag(CreatureStaticFlags2 flag) const { return _staticFlags.HasFlag(flag); }
         bool HasStaticFlag(CreatureStaticFlags3 flag) const { return _staticFlags.HasFlag(flag); }
@@ -490,6 +500,8 @@ class TC_GAME_API Creature : public Unit, public GridObject<Creature>, public Ma
         CreatureGroup* m_formation;
         bool m_triggerJustAppeared;
         bool m_respawnCompatibilityMode;
+        Trinity::SkippedUpdates _skippedUpdates;
+        bool _farFromPlayers;
 
         // Spell Focusing
         CreatureSpellFocusData _spellFocusInfo;
@@ -30,6 +30,7 @@
 #include "Transport.h"
 #include "Unit.h"
 #include "UpdateData.h"
+#include "UpdateFieldFlags.h"
 
 DynamicObject::DynamicObject(bool isWorldObject) : WorldObject(isWorldObject),
     _aura(nullptr), _removedAura(nullptr), _caster(nullptr), _duration(0), _isViewpoint(false)
@@ -173,14 +174,15 @@ void DynamicObject::BuildValuesUpdate(uint8 updateType, ByteBuffer* data, Player
     if (!target)
         return;
 
-    ByteBuffer fieldBuffer;
+    UpdateBufferLease fieldBufferLease;
+    ByteBuffer& fieldBuffer = *fieldBufferLease;
     UpdateMaskPacketBuilder updateMask(m_valuesCount);
 
     uint32* flags = nullptr;
     uint32 visibleFlag = GetUpdateFieldData(target, flags);
     ASSERT(flags);
 
-    for (uint16 index = 0; index < m_valuesCount; ++index)
+    VisitValuesUpdateFields(m_valuesCount, updateType == UPDATETYPE_VALUES, [&](uint16 index)
     {
         if (_fieldNotifyFlags & flags[index] ||
             ((updateType == UPDATETYPE_VALUES ? _changesMask.GetBit(index) : m_uint32Values[index]) && (flags[index] & visibleFlag)))
@@ -200,7 +202,7 @@ void DynamicObject::BuildValuesUpdate(uint8 updateType, ByteBuffer* data, Player
                             if (alternativeVisual && !caster->IsFriendlyTo(target))
                             {
                                 fieldBuffer << (rootVisual->AlternativeVisualID | (DYNAMIC_OBJECT_AREA_SPELL << 28));
-                                continue;
+                                return;
                             }
                         }
                     }
@@ -209,12 +211,26 @@ void DynamicObject::BuildValuesUpdate(uint8 updateType, ByteBuffer* data, Player
 
             fieldBuffer << m_uint32Values[index];
         }
-    }
+    });
 
     updateMask.AppendToPacket(data);
     data->append(fieldBuffer);
 }
 
+bool DynamicObject::HasViewerDependentValuesUpdate(uint8 updateType) const
+{
+    if (!IsFieldInValuesUpdate(updateType, DYNAMICOBJECT_BYTES, DynamicObjectUpdateFieldFlags))
+        return false;
+
+    // hostile viewers get the alternative visual
+    SpellInfo const* spellInfo = GetSpellInfo();
+    if (!spellInfo)
+        return false;
+
+    SpellVisualEntry const* rootVisual = sSpellVisualStore.LookupEntry(spellInfo->SpellVisual[0]);
+    return rootVisual && rootVisual->AlternativeVisualID;
+}
+
 int32 DynamicObject::GetDuration() const
 {
     if (!_aura)
@@ -44,6 +44,7 @@
 #include "QueryPackets.h"
 #include "SpellMgr.h"
 #include "Transport.h"
+#include "UpdateData.h"
 #include "UpdateFieldFlags.h"
 #include "World.h"
 #include <G3D/Box.h>
@@ -2887,7 +2888,8 @@ void GameObject::BuildValuesUpdate(uint8 updateType, ByteBuffer* data, Player* t
     bool forcedFlags = GetGoType() == GAMEOBJECT_TYPE_CHEST && GetGOInfo()->chest.usegrouplootrules && HasLootRecipient();
     bool targetIsGM = target->IsGameMaster();
 
-    ByteBuffer fieldBuffer;
+    UpdateBufferLease fieldBufferLease;
+    ByteBuffer& fieldBuffer = *fieldBufferLease;
 
     UpdateMaskPacketBuilder updateMask(m_valuesCount);
 
@@ -2896,7 +2898,7 @@ void GameObject::BuildValuesUpdate(uint8 updateType, ByteBuffer* data, Player* t
     if (GetOwnerGUID() == target->GetGUID())
         visibleFlag |= UF_FLAG_OWNER;
 
-    for (uint16 index = 0; index < m_valuesCount; ++index)
+    VisitValuesUpdateFields(m_valuesCount, updateType == UPDATETYPE_VALUES && !forcedFlags, [&](uint16 index)
     {
         if (_fieldNotifyFlags & flags[index] ||
             ((updateType == UPDATETYPE_VALUES ? _changesMask.GetBit(index) : m_uint32Values[index]) && (flags[index] & visibleFlag)) ||
@@ -2952,12 +2954,30 @@ void GameObject::BuildValuesUpdate(uint8 updateType, ByteBuffer* data, Player* t
             else
                 fieldBuffer << m_uint32Values[index];                // other cases
         }
-    }
+    });
 
     updateMask.AppendToPacket(data);
     data->append(fieldBuffer);
 }
 
+bool GameObject::HasViewerDependentValuesUpdate(uint8 updateType) const
+{
+    if (GetGoType() == GAMEOBJECT_TYPE_CHEST && GetGOInfo()->chest.usegrouplootrules)
+        return true;
+
+    // quest sparkles of BuildValuesUpdate
+    switch (GetGoType())
+    {
+        case GAMEOBJECT_TYPE_QUESTGIVER:
+        case GAMEOBJECT_TYPE_CHEST:
+        case GAMEOBJECT_TYPE_GOOBER:
+        case GAMEOBJECT_TYPE_GENERIC:
+            return IsFieldInValuesUpdate(updateType, GAMEOBJECT_DYNAMIC, GameObjectUpdateFieldFlags);
+        default:
+            return false;
+    }
+}
+
 std::vector<uint32> const* GameObject::GetPauseTimes() const
 {
     if (GameObjectType::Transport const* transport = dynamic_cast<GameObjectType::Transport const*>(m_goTypeImpl.get()))
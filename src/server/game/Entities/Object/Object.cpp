@@ -19,6 +19,7 @@
 #include "BattlefieldMgr.h"
 #include "Battleground.h"
 #include "CellImpl.h"
+#include "CellSpatialIndex.h"
 #include "Chat.h"
 #include "CinematicMgr.h"
 #include "CombatLogPackets.h"
@@ -42,6 +43,7 @@
 #include "PathGenerator.h"
 #include "Player.h"
 #include "ReputationMgr.h"
+#include "ReusableBuffer.h"
 #include "SpellAuraEffects.h"
 #include "SpellDefines.h"
 #include "SpellMgr.h"
@@ -79,6 +81,7 @@ Object::Object()
     m_uint32Values      = nullptr;
     m_valuesCount       = 0;
     _fieldNotifyFlags   = UF_FLAG_DYNAMIC;
+    _createValuesVersion = 0;
 
     m_inWorld           = false;
     m_isNewObject       = false;
@@ -88,6 +91,8 @@ Object::Object()
 
 WorldObject::~WorldObject()
 {
+    CellSpatialIndex::Remove(this);
+
     // this may happen because there are many !create/delete
     if (IsWorldObject() && m_currMap)
     {
@@ -213,14 +218,56 @@ void Object::BuildCreateUpdateBlockForPlayer(UpdateData* data, Player* target) c
             flags.CombatVictim = true;
     }
 
-    ByteBuffer buf(500);
+    ByteBuffer& buf = data->StartUpdateBlock(this);
     buf << uint8(updateType);
     buf << GetPackGUID();
     buf << uint8(m_objectTypeId);
 
+    // movement is written for every viewer, it holds the current time
     BuildMovementUpdate(&buf, flags);
-    BuildValuesUpdate(updateType, &buf, target);
-    data->AddUpdateBlock(buf);
+    BuildCreateValuesUpdate(updateType, &buf, target);
+}
+
+void Object::BuildCreateValuesUpdate(uint8 updateType, ByteBuffer* data, Player* target) const
+{
+    // only creatures and gameobjects are seen unchanged by many players, objects of a region updated in parallel may be built by several threads
+    bool cacheable = (IsCreature() || IsGameObject()) && target != this && !HasViewerDependentValuesUpdate(updateType);
+    if (cacheable)
+    {
+        Map const* map = static_cast<WorldObject const*>(this)->FindMap();
+        cacheable = map && !map->IsRegionUpdateActive();
+    }
+
+    if (!cacheable)
+    {
+        BuildValuesUpdate(updateType, data, target);
+        return;
+    }
+
+    if (_createValuesVersion != _changesMask.GetVersion())
+    {
+        _createValuesBlocks.clear();
+        _createValuesVersion = _changesMask.GetVersion();
+    }
+
+    uint32* flags = nullptr;
+    uint32 visibleFlag = GetUpdateFieldData(target, flags);
+    auto itr = std::find_if(_createValuesBlocks.begin(), _createValuesBlocks.end(), [visibleFlag](ValuesUpdateBlockCache::value_type const& block)
+    {
+        return block.first == visibleFlag;
+    });
+
+    if (itr == _createValuesBlocks.end())
+    {
+        // create and create2 updates have the same values part
+        UpdateBufferLease values;
+        BuildValuesUpdate(updateType, &*values, target);
+        _createValuesBlocks.emplace_back(visibleFlag, ByteBuffer(values->size()));
+        itr = std::prev(_createValuesBlocks.end());
+        itr->second.append(*values);
+    }
+
+    data->append(itr->second);
 }
 
 void Object::SendUpdateToPlayer(Player* player)
@@ -241,9 +288,9 @@ void Object::SendUpdateToSet()
 {
     if (Unit* unit = ToUnit())
     {
-        std::list<Player*> players;
-        unit->GetPlayerListInGrid(players, unit->GetVisibilityRange());
-        for (auto itr = players.begin(); itr != players.end(); itr++)
+        Trinity::ReusableBuffer<Player*> players;
+        unit->GetPlayerListInGrid(*players, unit->GetVisibilityRange());
+        for (auto itr = players->begin(); itr != players->end(); itr++)
         {
             UpdateData upd((*itr)->GetMapId());
             WorldPacket packet;
@@ -257,14 +304,43 @@ void Object::SendUpdateToSet()
 
 void Object::BuildValuesUpdateBlockForPlayer(UpdateData* data, Player* target) const
 {
-    ByteBuffer buf(500);
+    BuildValuesUpdateBlock(data->StartUpdateBlock(this), target);
+}
 
-    buf << uint8(UPDATETYPE_VALUES);
-    buf << GetPackGUID();
+bool Object::IsPriorityUpdateFor(Player const* target) const
+{
+    if (GetTypeId() == TYPEID_ITEM || GetTypeId() == TYPEID_CONTAINER)
+        return false;
 
-    BuildValuesUpdate(UPDATETYPE_VALUES, &buf, target);
+    // passengers stay behind the create of their transport
+    WorldObject const* worldObject = static_cast<WorldObject const*>(this);
+    if (!worldObject->m_movementInfo.transport.guid.IsEmpty())
+        return false;
+
+    if (target == this)
+        return true;
+
+    if (Unit const* unit = ToUnit())
+        if (unit->IsInCombatWith(target))
+            return true;
 
-    data->AddUpdateBlock(buf);
+    return worldObject->GetExactDist2dSq(target) < UPDATE_PRIORITY_DISTANCE * UPDATE_PRIORITY_DISTANCE;
+}
+
+void Object::BuildValuesUpdateBlock(ByteBuffer& block, Player* target) const
+{
+    block << uint8(UPDATETYPE_VALUES);
+    block << GetPackGUID();
+
+    BuildValuesUpdate(UPDATETYPE_VALUES, &block, target);
+}
+
+bool Object::IsFieldInValuesUpdate(uint8 updateType, uint16 index, uint32 const* flags) const
+{
+    if (_fieldNotifyFlags & flags[index])
+        return true;
+
+    return updateType == UPDATETYPE_VALUES ? _changesMask.GetBit(index) : m_uint32Values[index] != 0;
 }
 
 void Object::BuildOutOfRangeUpdateBlock(UpdateData* data) const
@@ -670,14 +746,15 @@ void Object::BuildValuesUpdate(uint8 updateType, ByteBuffer* data, Player* targe
     if (!target)
         return;
 
-    ByteBuffer fieldBuffer;
+    UpdateBufferLease fieldBufferLease;
+    ByteBuffer& fieldBuffer = *fieldBufferLease;
     UpdateMaskPacketBuilder updateMask(m_valuesCount);
 
     uint32* flags = nullptr;
     uint32 visibleFlag = GetUpdateFieldData(target, flags);
     ASSERT(flags);
 
-    for (uint16 index = 0; index < m_valuesCount; ++index)
+    VisitValuesUpdateFields(m_valuesCount, updateType == UPDATETYPE_VALUES, [&](uint16 index)
     {
         if (_fieldNotifyFlags & flags[index] ||
             ((updateType == UPDATETYPE_VALUES ? _changesMask.GetBit(index) : m_uint32Values[index]) && (flags[index] & visibleFlag)))
@@ -685,12 +762,76 @@ void Object::BuildValuesUpdate(uint8 updateType, ByteBuffer* data, Player* targe
             updateMask.SetBit(index);
             fieldBuffer << m_uint32Values[index];
         }
-    }
+    });
 
     updateMask.AppendToPacket(data);
     data->append(fieldBuffer);
 }
 
+namespace
+{
+    template<std::size_t N>
+    std::vector<uint16> CollectUpdateFields(uint32 const (&flags)[N], uint32 flag)
+    {
+        std::vector<uint16> fields;
+        for (uint16 index = 0; index < N; ++index)
+            if (flags[index] & flag)
+                fields.push_back(index);
+
+        return fields;
+    }
+}
+
+std::vector<uint16> const* Object::GetNotifiedUpdateFields() const
+{
+    static std::vector<uint16> const NoFields;
+
+    // other notify flags match most fields of an object
+    if (_fieldNotifyFlags & ~UF_FLAG_DYNAMIC)
+        return nullptr;
+
+    if (!(_fieldNotifyFlags & UF_FLAG_DYNAMIC))
+        return &NoFields;
+
+    switch (GetTypeId())
+    {
+        case TYPEID_ITEM:
+        case TYPEID_CONTAINER:
+        {
+            static std::vector<uint16> const ItemFields = CollectUpdateFields(ItemUpdateFieldFlags, UF_FLAG_DYNAMIC);
+            return &ItemFields;
+        }
+        case TYPEID_UNIT:
+        case TYPEID_PLAYER:
+        {
+            static std::vector<uint16> const UnitFields = CollectUpdateFields(UnitUpdateFieldFlags, UF_FLAG_DYNAMIC);
+            return &UnitFields;
+        }
+        case TYPEID_GAMEOBJECT:
+        {
+            static std::vector<uint16> const GameObjectFields = CollectUpdateFields(GameObjectUpdateFieldFlags, UF_FLAG_DYNAMIC);
+            return &GameObjectFields;
+        }
+        case TYPEID_DYNAMICOBJECT:
+        {
+            static std::vector<uint16> const DynamicObjectFields = CollectUpdateFields(DynamicObjectUpdateFieldFlags, UF_FLAG_DYNAMIC);
+            return &DynamicObjectFields;
+        }
+        case TYPEID_CORPSE:
+        {
+            static std::vector<uint16> const CorpseFields = CollectUpdateFields(CorpseUpdateFieldFlags, UF_FLAG_DYNAMIC);
+            return &CorpseFields;
+        }
+        case TYPEID_AREATRIGGER:
+        {
+            static std::vector<uint16> const AreaTriggerFields = CollectUpdateFields(AreaTriggerUpdateFieldFlags, UF_FLAG_DYNAMIC);
+            return &AreaTriggerFields;
+        }
+        default:
+            return nullptr;
+    }
+}
+
 void Object::AddToObjectUpdateIfNeeded()
 {
     if (m_inWorld && !m_objectUpdated)
@@ -710,7 +851,7 @@ void Object::ClearUpdateMask(bool remove)
     }
 }
 
-void Object::BuildFieldsUpdate(Player* player, UpdateDataMapType& data_map) const
+void Object::BuildFieldsUpdate(Player* player, UpdateDataMapType& data_map, ValuesUpdateBlockCache* sharedBlocks /*= nullptr*/) const
 {
     UpdateDataMapType::iterator iter = data_map.find(player);
 
@@ -721,7 +862,27 @@ void Object::BuildFieldsUpdate(Player* player, UpdateDataMapType& data_map) cons
         iter = p.first;
     }
 
-    BuildValuesUpdateBlockForPlayer(&iter->second, iter->first);
+    if (!sharedBlocks)
+    {
+        BuildValuesUpdateBlockForPlayer(&iter->second, iter->first);
+        return;
+    }
+
+    // every viewer with the same visibility flags gets the same block
+    uint32* flags = nullptr;
+    uint32 visibleFlag = GetUpdateFieldData(player, flags);
+    auto block = std::find_if(sharedBlocks->begin(), sharedBlocks->end(), [visibleFlag](std::pair<uint32, ByteBuffer> const& shared)
+    {
+        return shared.first == visibleFlag;
+    });
+
+    if (block == sharedBlocks->end())
+    {
+        block = sharedBlocks->emplace(sharedBlocks->end(), visibleFlag, ByteBuffer(500));
+        BuildValuesUpdateBlock(block->second, player);
+    }
+
+    iter->second.AddUpdateBlock(block->second, this);
 }
 
 uint32 Object::GetUpdateFieldData(Player const* target, uint32*& flags) const
@@ -1130,7 +1291,7 @@ WorldObject::WorldObject(bool isWorldObject) : Object(), WorldLocation(), LastUs
 m_movementInfo(), m_name(""), m_isActive(false), m_isFarVisible(false), m_isWorldObject(isWorldObject), m_zoneScript(nullptr),
 m_transport(nullptr), m_zoneId(0), m_areaId(0), m_staticFloorZ(VMAP_INVALID_HEIGHT), m_outdoors(true), m_liquidStatus(LIQUID_MAP_NO_WATER),
 m_wmoGroupID(0), m_currMap(nullptr), m_InstanceId(0), _dbPhase(0), m_notifyflags(0), _heartbeatTimer(HEARTBEAT_INTERVAL),
-m_aiAnimKitId(0), m_movementAnimKitId(0), m_meleeAnimKitId(0)
+_cellIndex(nullptr), _cellIndexRow(0), m_aiAnimKitId(0), m_movementAnimKitId(0), m_meleeAnimKitId(0)
 {
     m_serverSideVisibility.SetValue(SERVERSIDE_VISIBILITY_GHOST, GHOST_VISIBILITY_ALIVE | GHOST_VISIBILITY_GHOST);
     m_serverSideVisibilityDetect.SetValue(SERVERSIDE_VISIBILITY_GHOST, GHOST_VISIBILITY_ALIVE);
@@ -1216,6 +1377,8 @@ void WorldObject::UpdatePositionData()
     PositionFullTerrainStatus data;
     GetMap()->GetFullTerrainStatusForPosition(GetPhaseShift(), GetPositionX(), GetPositionY(), GetPositionZ(), data, map_liquidHeaderTypeFlags::AllLiquids, GetCollisionHeight());
     ProcessPositionDataChanged(data);
+
+    CellSpatialIndex::Update(this);
 }
 
 void WorldObject::ProcessPositionDataChanged(PositionFullTerrainStatus const& data)
@@ -1681,6 +1844,8 @@ float WorldObject::GetSightRange(const WorldObject* target) const
                 return MAX_VISIBILITY_DISTANCE;
             else if (ToPlayer()->GetCinematicMgr()->IsOnCinematic())
                 return DEFAULT_VISIBILITY_INSTANCE;
+            else if (target && ToPlayer()->GetVisibilityRangeLimit() > 0.0f && !ToPlayer()->IsExemptFromVisibilityRangeLimit(target))
+                return std::min(ToPlayer()->GetVisibilityRangeLimit(), GetMap()->GetVisibilityRange());
             else
                 return GetMap()->GetVisibilityRange();
         }
@@ -2001,6 +2166,8 @@ void WorldObject::AddObjectToRemoveList()
 
 TempSummon* Map::SummonCreature(uint32 entry, Position const& pos, SummonCreatureExtraArgs const& summonArgs /*= { }*/)
 {
+    RegionGuard guard(this);
+
     uint32 mask = UNIT_MASK_SUMMON;
 
     if (summonArgs.SummonProperties)
@@ -3273,24 +3440,37 @@ template <typename Container>
 void WorldObject::GetGameObjectListWithEntryInGrid(Container& gameObjectContainer, uint32 entry, float maxSearchRange /*= 250.0f*/) const
 {
     Trinity::AllGameObjectsWithEntryInRange check(this, entry, maxSearchRange);
-    Trinity::GameObjectListSearcher<Trinity::AllGameObjectsWithEntryInRange> searcher(this, gameObjectContainer, check);
-    Cell::VisitGridObjects(this, searcher, maxSearchRange);
+    GetMap()->VisitIndexedObjects(GetPositionX(), GetPositionY(), maxSearchRange + GetCombatReach(), TYPEMASK_GAMEOBJECT, CELL_INDEX_GRID_CONTAINER, GetPhaseShift().GetSummary(), [&](WorldObject* object)
+    {
+        GameObject* gameObject = object->ToGameObject();
+        if (gameObject->IsInPhase(this) && check(gameObject))
+            gameObjectContainer.push_back(gameObject);
+    });
 }
 
 template <typename Container>
 void WorldObject::GetCreatureListWithEntryInGrid(Container& creatureContainer, uint32 entry, float maxSearchRange /*= 250.0f*/) const
 {
     Trinity::AllCreaturesOfEntryInRange check(this, entry, maxSearchRange);
-    Trinity::CreatureListSearcher<Trinity::AllCreaturesOfEntryInRange> searcher(this, creatureContainer, check);
-    Cell::VisitGridObjects(this, searcher, maxSearchRange);
+    // players are units too but never live in the grid container
+    GetMap()->VisitIndexedObjects(GetPositionX(), GetPositionY(), maxSearchRange + GetCombatReach(), TYPEMASK_UNIT, CELL_INDEX_GRID_CONTAINER, GetPhaseShift().GetSummary(), [&](WorldObject* object)
+    {
+        Creature* creature = object->ToCreature();
+        if (creature && creature->IsInPhase(this) && check(creature))
+            creatureContainer.push_back(creature);
+    });
 }
 
 template <typename Container>
 void WorldObject::GetPlayerListInGrid(Container& playerContainer, float maxSearchRange) const
 {
     Trinity::AnyPlayerInObjectRangeCheck checker(this, maxSearchRange);
-    Trinity::PlayerListSearcher<Trinity::AnyPlayerInObjectRangeCheck> searcher(this, playerContainer, checker);
-    Cell::VisitWorldObjects(this, searcher, maxSearchRange);
+    GetMap()->VisitIndexedObjects(GetPositionX(), GetPositionY(), maxSearchRange + GetCombatReach(), TYPEMASK_PLAYER, CELL_INDEX_WORLD_CONTAINER, GetPhaseShift().GetSummary(), [&](WorldObject* object)
+    {
+        Player* player = object->ToPlayer();
+        if (player->IsInPhase(this) && checker(player))
+            playerContainer.push_back(player);
+    });
 }
 
 void WorldObject::GetNearPoint2D(WorldObject const* searcher, float &x, float &y, float distance2d, float absAngle) const
@@ -3571,14 +3751,12 @@ void WorldObject::DestroyForNearbyPlayers()
     if (!IsInWorld())
         return;
 
-    std::list<Player*> targets;
+    Trinity::ReusableBuffer<Player*> targets;
     Trinity::AnyPlayerInObjectRangeCheck check(this, GetVisibilityRange(), false);
-    Trinity::PlayerListSearcher<Trinity::AnyPlayerInObjectRangeCheck> searcher(this, targets, check);
+    Trinity::PlayerListSearcher<Trinity::AnyPlayerInObjectRangeCheck> searcher(this, *targets, check);
     Cell::VisitWorldObjects(this, searcher, GetVisibilityRange());
-    for (std::list<Player*>::const_iterator iter = targets.begin(); iter != targets.end(); ++iter)
+    for (Player* player : *targets)
     {
-        Player* player = (*iter);
-
         if (player == this)
             continue;
 
@@ -3597,8 +3775,15 @@ void WorldObject::DestroyForNearbyPlayers()
     }
 }
 
+void WorldObject::SetVisibilityChanged()
+{
+    _visibilityChangeTime = GameTime::GetGameTimeSteadyPoint();
+}
+
 void WorldObject::UpdateObjectVisibility(bool /*forced*/)
 {
+    SetVisibilityChanged();
+
     //updates object's visibility for nearby players
     Trinity::VisibleChangesNotifier notifier(*this);
     Cell::VisitWorldObjects(this, notifier, GetVisibilityRange());
@@ -3608,8 +3793,9 @@ struct WorldObjectChangeAccumulator
 {
     UpdateDataMapType& i_updateDatas;
     WorldObject& i_object;
+    ValuesUpdateBlockCache* i_sharedBlocks;
     GuidSet plr_list;
-    WorldObjectChangeAccumulator(WorldObject &obj, UpdateDataMapType &d) : i_updateDatas(d), i_object(obj) { }
+    WorldObjectChangeAccumulator(WorldObject &obj, UpdateDataMapType &d, ValuesUpdateBlockCache* sharedBlocks) : i_updateDatas(d), i_object(obj), i_sharedBlocks(sharedBlocks) { }
     void Visit(PlayerMapType &m)
     {
         Player* source = nullptr;
@@ -3666,7 +3852,7 @@ struct WorldObjectChangeAccumulator
         // Only send update once to a player
         if (plr_list.find(player->GetGUID()) == plr_list.end() && player->HaveAtClient(&i_object))
         {
-            i_object.BuildFieldsUpdate(player, i_updateDatas);
+            i_object.BuildFieldsUpdate(player, i_updateDatas, i_sharedBlocks);
             plr_list.insert(player->GetGUID());
         }
     }
@@ -3676,7 +3862,9 @@ struct WorldObjectChangeAccumulator
 
 void WorldObject::BuildUpdate(UpdateDataMapType& data_map)
 {
-    WorldObjectChangeAccumulator notifier(*this, data_map);
+    // usually only a handful of visibility classes (public, party member, owner, self) among the viewers
+    ValuesUpdateBlockCache sharedBlocks;
+    WorldObjectChangeAccumulator notifier(*this, data_map, HasViewerDependentValuesUpdate(UPDATETYPE_VALUES) ? nullptr : &sharedBlocks);
     //we must build packets for all visible players
     Cell::VisitWorldObjects(this, notifier, GetVisibilityRange());
 
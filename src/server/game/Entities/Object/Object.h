@@ -38,6 +38,7 @@
 #include <unordered_map>
 
 class AreaTrigger;
+class CellSpatialIndex;
 class Corpse;
 class Creature;
 class CreatureAI;
@@ -62,6 +63,8 @@ struct QuaternionData;
 enum ZLiquidStatus : uint32;
 
 typedef std::unordered_map<Player*, UpdateData> UpdateDataMapType;
+// values update blocks by visibility flags of their viewers
+typedef std::vector<std::pair<uint32, ByteBuffer>> ValuesUpdateBlockCache;
 
 struct CreateObjectBits
 {
@@ -114,6 +117,8 @@ class TC_GAME_API Object
         virtual void BuildCreateUpdateBlockForPlayer(UpdateData* data, Player* target) const;
         void SendUpdateToPlayer(Player* player);
         void SendUpdateToSet();
+        // blocks of objects near or fighting with target are sent first when its update is split
+        bool IsPriorityUpdateFor(Player const* target) const;
 
         void BuildValuesUpdateBlockForPlayer(UpdateData* data, Player* target) const;
         void BuildOutOfRangeUpdateBlock(UpdateData* data) const;
@@ -178,10 +183,10 @@ class TC_GAME_API Object
         bool IsDestroyedObject() const { return m_isDestroyedObject; }
         void SetDestroyedObject(bool destroyed) { m_isDestroyedObject = destroyed; }
         virtual void BuildUpdate(UpdateDataMapType&) { }
-        void BuildFieldsUpdate(Player*, UpdateDataMapType &) const;
+        void BuildFieldsUpdate(Player*, UpdateDataMapType &, ValuesUpdateBlockCache* sharedBlocks = nullptr) const;
 
-        void SetFieldNotifyFlag(uint16 flag) { _fieldNotifyFlags |= flag; }
-        void RemoveFieldNotifyFlag(uint16 flag) { _fieldNotifyFlags &= uint16(~flag); }
+        void SetFieldNotifyFlag(uint16 flag) { _fieldNotifyFlags |= flag; _createValuesBlocks.clear(); }
+        void RemoveFieldNotifyFlag(uint16 flag) { _fieldNotifyFlags &= uint16(~flag); _createValuesBlocks.clear(); }
 
         // FG: some hacky helpers
         void ForceValuesUpdateAtIndex(uint32);
@@ -226,6 +231,42 @@ class TC_GAME_API Object
 
         void BuildMovementUpdate(ByteBuffer* data, CreateObjectBits flags) const;
         virtual void BuildValuesUpdate(uint8 updatetype, ByteBuffer* data, Player* target) const;
+        void BuildValuesUpdateBlock(ByteBuffer& block, Player* target) const;
+        void BuildCreateValuesUpdate(uint8 updateType, ByteBuffer* data, Player* target) const;
+        // true when an update of updateType holds fields whose value depends on more than the visibility flags of the viewer
+        virtual bool HasViewerDependentValuesUpdate(uint8 /*updateType*/) const { return false; }
+        bool IsFieldInValuesUpdate(uint8 updateType, uint16 index, uint32 const* flags) const;
+
+        // fields always part of a values update due to _fieldNotifyFlags, nullptr when there are too many to list them
+        std::vector<uint16> const* GetNotifiedUpdateFields() const;
+
+        // Calls visit with every field below valCount that may be part of a values update, in index order.
+        // With changesOnly that is only the changed and the notified fields, visit still decides whether a field is sent.
+        template<typename Visitor>
+        void VisitValuesUpdateFields(uint32 valCount, bool changesOnly, Visitor&& visit) const
+        {
+            std::vector<uint16> const* notifiedFields = changesOnly ? GetNotifiedUpdateFields() : nullptr;
+            if (!notifiedFields)
+            {
+                for (uint16 index = 0; index < valCount; ++index)
+                    visit(index);
+                return;
+            }
+
+            // merge of both sorted sequences, a changed and notified field is visited once
+            auto notified = notifiedFields->begin();
+            _changesMask.ForEachSetBit([&](uint32 index)
+            {
+                for (; notified != notifiedFields->end() && *notified <= index; ++notified)
+                    if (*notified < index)
+                        visit(*notified);
+
+                visit(uint16(index));
+            }, valCount);
+
+            for (; notified != notifiedFields->end() && *notified < valCount; ++notified)
+                visit(*notified);
+        }
 
         uint16 m_objectType;
 
@@ -245,6 +286,10 @@ class TC_GAME_API Object
 
         uint16 _fieldNotifyFlags;
 
+        // values part of create blocks by visibility flags of their viewers, valid while the fields stay at _createValuesVersion
+        mutable ValuesUpdateBlockCache _createValuesBlocks;
+        mutable uint32 _createValuesVersion;
+
         virtual bool AddToObjectUpdate() = 0;
         virtual void RemoveFromObjectUpdate() = 0;
         void AddToObjectUpdateIfNeeded();
@@ -515,6 +560,10 @@ class TC_GAME_API WorldObject : public Object, public WorldLocation
         virtual void UpdateObjectVisibilityOnDestroy() { DestroyForNearbyPlayers(); }
         void UpdatePositionData();
 
+        // Last time something that can change how others see this object happened, relocations included
+        std::chrono::steady_clock::time_point GetVisibilityChangeTime() const { return _visibilityChangeTime; }
+        void SetVisibilityChanged();
+
         void BuildUpdate(UpdateDataMapType&) override;
 
         bool AddToObjectUpdate() override;
@@ -612,6 +661,8 @@ class TC_GAME_API WorldObject : public Object, public WorldLocation
 
         virtual void Heartbeat() { }
     private:
+        friend class CellSpatialIndex;
+
         Map* m_currMap;                                   // current object's Map location
 
         uint32 m_InstanceId;                              // in map copy with instance id
@@ -620,11 +671,15 @@ class TC_GAME_API WorldObject : public Object, public WorldLocation
         int32 _dbPhase;
 
         uint16 m_notifyflags;
+        std::chrono::steady_clock::time_point _visibilityChangeTime;
 
         ObjectGuid _privateObjectOwner;
 
         Milliseconds _heartbeatTimer;
 
+        CellSpatialIndex* _cellIndex;                     // packed row of the cell this object is in, see Map::AddToGrid
+        uint32 _cellIndexRow;
+
         virtual bool _IsWithinDist(WorldObject const* obj, float dist2compare, bool is3D, bool incOwnRadius = true, bool incTargetRadius = true) const;
 
         bool CanNeverSee(WorldObject const* obj) const;
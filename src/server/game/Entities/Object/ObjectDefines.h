@@ -25,6 +25,7 @@ static constexpr float const INTERACTION_DISTANCE           = 5.0f;
 static constexpr float const ATTACK_DISTANCE                = 5.0f;
 static constexpr float const INSPECT_DISTANCE               = 28.0f;
 static constexpr float const TRADE_DISTANCE                 = 11.11f;
+static constexpr float const UPDATE_PRIORITY_DISTANCE       = 30.0f;                    // objects within are sent first when an object update is split
 #define MAX_VISIBILITY_DISTANCE                             SIZE_OF_GRIDS               // max distance for visible objects
 static constexpr float const SIGHT_RANGE_UNIT               = 50.0f;
 static constexpr float const VISIBILITY_DISTANCE_GIGANTIC   = 400.0f;
@@ -77,6 +78,7 @@ enum NotifyFlags
     NOTIFY_NONE                     = 0x00,
     NOTIFY_AI_RELOCATION            = 0x01,
     NOTIFY_VISIBILITY_CHANGED       = 0x02,
+    NOTIFY_VISIBILITY_RECHECK_ALL   = 0x04,                 // viewer state changed, not only its position, see PlayerRelocationNotifier
     NOTIFY_ALL                      = 0xFF
 };
 
@@ -17,11 +17,50 @@
 
 #include "UpdateData.h"
 #include "Errors.h"
+#include "Object.h"
 #include "Opcodes.h"
 #include "World.h"
 #include "WorldPacket.h"
 
-UpdateData::UpdateData(uint16 map) : m_map(map), m_blockCount(0) { }
+namespace
+{
+    // buffers grown beyond this are released instead of being kept by the pool
+    constexpr std::size_t MaxPooledBufferSize = 0x10000;
+    constexpr std::size_t MaxPooledBytes = 4 * 1024 * 1024;
+
+    thread_local std::vector<ByteBuffer> BufferPool;
+    thread_local std::size_t BufferPoolBytes = 0;
+}
+
+UpdateData::UpdateData(uint16 map) : m_map(map), m_data(AcquireBuffer()) { }
+
+UpdateData::~UpdateData()
+{
+    ReleaseBuffer(std::move(m_data));
+}
+
+ByteBuffer UpdateData::AcquireBuffer()
+{
+    if (BufferPool.empty())
+        return ByteBuffer();
+
+    ByteBuffer buffer(std::move(BufferPool.back()));
+    BufferPool.pop_back();
+    BufferPoolBytes -= buffer.capacity();
+    return buffer;
+}
+
+void UpdateData::ReleaseBuffer(ByteBuffer&& buffer)
+{
+    // moved from buffers own no storage
+    std::size_t capacity = buffer.capacity();
+    if (!capacity || capacity > MaxPooledBufferSize || BufferPoolBytes + capacity > MaxPooledBytes)
+        return;
+
+    buffer.clear();
+    BufferPool.push_back(std::move(buffer));
+    BufferPoolBytes += capacity;
+}
 
 void UpdateData::AddOutOfRangeGUID(GuidSet& guids)
 {
@@ -33,21 +72,20 @@ void UpdateData::AddOutOfRangeGUID(ObjectGuid guid)
     m_outOfRangeGUIDs.insert(guid);
 }
 
-void UpdateData::AddUpdateBlock(const ByteBuffer &block)
+void UpdateData::AddUpdateBlock(const ByteBuffer &block, Object const* source /*= nullptr*/)
 {
+    m_blocks.push_back({ uint32(m_data.wpos()), source });
     m_data.append(block);
-    ++m_blockCount;
 }
 
-bool UpdateData::BuildPacket(WorldPacket* packet)
+void UpdateData::BuildPacketHeader(WorldPacket* packet, uint32 blockCount, std::size_t dataSize, bool outOfRange) const
 {
-    ASSERT(packet->empty());                                // shouldn't happen
-    packet->Initialize(SMSG_UPDATE_OBJECT, 2 + 4 + (m_outOfRangeGUIDs.empty() ? 0 : 1 + 4 + 9 * m_outOfRangeGUIDs.size()) + m_data.wpos());
+    packet->Initialize(SMSG_UPDATE_OBJECT, 2 + 4 + (outOfRange ? 1 + 4 + 9 * m_outOfRangeGUIDs.size() : 0) + dataSize);
 
     *packet << uint16(m_map);
-    *packet << uint32(m_blockCount + (m_outOfRangeGUIDs.empty() ? 0 : 1));
+    *packet << uint32(blockCount + (outOfRange ? 1 : 0));
 
-    if (!m_outOfRangeGUIDs.empty())
+    if (outOfRange)
     {
         *packet << uint8(UPDATETYPE_OUT_OF_RANGE_OBJECTS);
         *packet << uint32(m_outOfRangeGUIDs.size());
@@ -55,15 +93,100 @@ bool UpdateData::BuildPacket(WorldPacket* packet)
         for (GuidSet::const_iterator i = m_outOfRangeGUIDs.begin(); i != m_outOfRangeGUIDs.end(); ++i)
             *packet << i->WriteAsPacked();
     }
+}
 
+bool UpdateData::BuildPacket(WorldPacket* packet)
+{
+    ASSERT(packet->empty());                                // shouldn't happen
+    BuildPacketHeader(packet, uint32(m_blocks.size()), m_data.wpos(), !m_outOfRangeGUIDs.empty());
     packet->append(m_data);
     return true;
 }
 
+void UpdateData::BuildPackets(std::vector<WorldPacket>& packets, Player const* receiver /*= nullptr*/)
+{
+    // map id and block count, the out of range block is sized for unpacked guids
+    std::size_t const headerSize = 2 + 4;
+    std::size_t const outOfRangeSize = m_outOfRangeGUIDs.empty() ? 0 : 1 + 4 + 9 * m_outOfRangeGUIDs.size();
+    std::size_t const maxSize = sWorld->getIntConfig(CONFIG_UPDATE_OBJECT_MAX_PACKET_SIZE);
+    bool const skipValuesCompression = sWorld->getBoolConfig(CONFIG_COMPRESSION_SKIP_VALUES_UPDATES);
+
+    // values updates are short lived fresh values, they gain little from the deflate stream of the socket
+    bool hasCreate = false;
+    auto addBlockType = [&](uint32 index)
+    {
+        hasCreate = hasCreate || m_data.contents()[m_blocks[index].Offset] != UPDATETYPE_VALUES;
+    };
+
+    auto setCompressionHint = [&](WorldPacket& packet)
+    {
+        if (skipValuesCompression && !hasCreate)
+            packet.SetCompressible(false);
+
+        hasCreate = false;
+    };
+
+    if (!maxSize || headerSize + outOfRangeSize + m_data.wpos() <= maxSize)
+    {
+        WorldPacket& packet = packets.emplace_back();
+        BuildPacket(&packet);
+        for (uint32 index = 0; index < m_blocks.size(); ++index)
+            addBlockType(index);
+
+        setCompressionHint(packet);
+        return;
+    }
+
+    std::vector<uint32> packetBlocks;
+    std::size_t packetSize = outOfRangeSize;
+    bool outOfRange = !m_outOfRangeGUIDs.empty();
+    auto finishPacket = [&]()
+    {
+        WorldPacket& packet = packets.emplace_back();
+        BuildPacketHeader(&packet, uint32(packetBlocks.size()), packetSize, outOfRange);
+        for (uint32 index : packetBlocks)
+        {
+            addBlockType(index);
+            packet.append(m_data.contents() + m_blocks[index].Offset, GetBlockSize(index));
+        }
+
+        setCompressionHint(packet);
+        packetBlocks.clear();
+        packetSize = 0;
+        outOfRange = false;
+    };
+
+    // priority is only worth its distance checks when the update is actually split
+    std::vector<bool> priorities(m_blocks.size(), false);
+    if (receiver)
+        for (uint32 index = 0; index < m_blocks.size(); ++index)
+            priorities[index] = m_blocks[index].Source && m_blocks[index].Source->IsPriorityUpdateFor(receiver);
+
+    for (bool priority : { true, false })
+    {
+        for (uint32 index = 0; index < m_blocks.size(); ++index)
+        {
+            if (priorities[index] != priority)
+                continue;
+
+            // a block larger than the limit is sent alone
+            std::size_t blockSize = GetBlockSize(index);
+            if ((!packetBlocks.empty() || outOfRange) && headerSize + packetSize + blockSize > maxSize)
+                finishPacket();
+
+            packetBlocks.push_back(index);
+            packetSize += blockSize;
+        }
+    }
+
+    if (!packetBlocks.empty() || outOfRange)
+        finishPacket();
+}
+
 void UpdateData::Clear()
 {
     m_data.clear();
     m_outOfRangeGUIDs.clear();
-    m_blockCount = 0;
+    m_blocks.clear();
     m_map = 0;
 }
@@ -22,7 +22,10 @@
 #include "ByteBuffer.h"
 #include "ObjectGuid.h"
 #include <set>
+#include <vector>
 
+class Object;
+class Player;
 class WorldPacket;
 
 enum OBJECT_UPDATE_TYPE
@@ -37,28 +40,65 @@ class UpdateData
 {
     public:
         UpdateData(uint16 map);
-        UpdateData(UpdateData&& right) : m_map(right.m_map), m_blockCount(right.m_blockCount),
+        UpdateData(UpdateData&& right) : m_map(right.m_map), m_blocks(std::move(right.m_blocks)),
             m_outOfRangeGUIDs(std::move(right.m_outOfRangeGUIDs)),
             m_data(std::move(right.m_data))
         {
         }
+        ~UpdateData();
 
         void AddOutOfRangeGUID(GuidSet& guids);
         void AddOutOfRangeGUID(ObjectGuid guid);
-        void AddUpdateBlock(const ByteBuffer &block);
+        void AddUpdateBlock(const ByteBuffer &block, Object const* source = nullptr);
+        // the caller writes one whole block straight into the returned packet data
+        ByteBuffer& StartUpdateBlock(Object const* source = nullptr) { m_blocks.push_back({ uint32(m_data.wpos()), source }); return m_data; }
         bool BuildPacket(WorldPacket* packet);
-        bool HasData() const { return m_blockCount > 0 || !m_outOfRangeGUIDs.empty(); }
+        // Splits the update into packets of at most UpdateObject.MaxPacketSize bytes, blocks are never split.
+        // Out of range guids and the blocks of objects with priority for the receiver go to the first packets,
+        // the others keep their order. Sources must still exist, updates are sent in the tick they are built.
+        void BuildPackets(std::vector<WorldPacket>& packets, Player const* receiver = nullptr);
+        bool HasData() const { return !m_blocks.empty() || !m_outOfRangeGUIDs.empty(); }
         void Clear();
 
         GuidSet const& GetOutOfRangeGUIDs() const { return m_outOfRangeGUIDs; }
 
+        // Buffers are recycled through a per thread pool, keeping their storage across map ticks
+        static ByteBuffer AcquireBuffer();
+        static void ReleaseBuffer(ByteBuffer&& buffer);
+
     protected:
+        struct UpdateBlock
+        {
+            uint32 Offset;
+            Object const* Source;
+        };
+
+        std::size_t GetBlockSize(std::size_t index) const { return (index + 1 < m_blocks.size() ? m_blocks[index + 1].Offset : m_data.wpos()) - m_blocks[index].Offset; }
+        void BuildPacketHeader(WorldPacket* packet, uint32 blockCount, std::size_t dataSize, bool outOfRange) const;
+
         uint16 m_map;
-        uint32 m_blockCount;
+        std::vector<UpdateBlock> m_blocks;
         GuidSet m_outOfRangeGUIDs;
         ByteBuffer m_data;
 
         UpdateData(UpdateData const& right) = delete;
         UpdateData& operator=(UpdateData const& right) = delete;
 };
+
+// Scratch buffer from the UpdateData buffer pool, returned when going out of scope
+class UpdateBufferLease
+{
+    public:
+        UpdateBufferLease() : _buffer(UpdateData::AcquireBuffer()) { }
+        ~UpdateBufferLease() { UpdateData::ReleaseBuffer(std::move(_buffer)); }
+
+        UpdateBufferLease(UpdateBufferLease const&) = delete;
+        UpdateBufferLease& operator=(UpdateBufferLease const&) = delete;
+
+        ByteBuffer& operator*() { return _buffer; }
+        ByteBuffer* operator->() { return &_buffer; }
+
+    private:
+        ByteBuffer _buffer;
+};
 #endif
@@ -21,43 +21,54 @@
 #include "UpdateFields.h"
 #include "Errors.h"
 #include "ByteBuffer.h"
+#include "DirtyBitmap.h"
+#include <array>
 
 class UpdateMask
 {
 public:
-    UpdateMask() : _bits(nullptr), _fieldCount(0) { }
+    UpdateMask() : _version(0) { }
 
     void SetBit(uint32 index)
     {
-        _bits[index] = 1;
+        _bits.Set(index);
+        ++_version;
     }
 
     void UnsetBit(uint32 index)
     {
-        _bits[index] = 0;
+        _bits.Reset(index);
     }
 
     bool GetBit(uint32 index) const
     {
-        return _bits[index] != 0;
+        return _bits.Test(index);
     }
 
     void SetCount(uint32 valuesCount)
     {
-        _bits = std::make_unique<uint8[]>(valuesCount);
-        std::uninitialized_fill_n(&_bits[0], valuesCount, 0);
-        _fieldCount = valuesCount;
+        _bits.Resize(valuesCount);
+        ++_version;
     }
 
     void Clear()
     {
-        if (_bits)
-            std::fill_n(&_bits[0], _fieldCount, 0);
+        _bits.Clear();
     }
 
+    /// Calls visitor with the index of every set bit below limit, in ascending order
+    template<typename Visitor>
+    void ForEachSetBit(Visitor&& visitor, uint32 limit) const
+    {
+        _bits.ForEachSetBit(std::forward<Visitor>(visitor), limit);
+    }
+
+    /// Changes with every field write, unlike the bits it is not reset when an update was sent
+    uint32 GetVersion() const { return _version; }
+
 private:
-    std::unique_ptr<uint8[]> _bits;
-    uint32 _fieldCount;
+    Trinity::DirtyBitmap _bits;
+    uint32 _version;
 };
 
 class UpdateMaskPacketBuilder
@@ -71,11 +82,9 @@ public:
         CLIENT_UPDATE_MASK_BITS = sizeof(ClientUpdateMaskType) * 8,
     };
 
-    explicit UpdateMaskPacketBuilder(uint32 valuesCount) : _lastSetBit(0)
+    explicit UpdateMaskPacketBuilder(uint32 valuesCount) : _mask(), _lastSetBit(0)
     {
-        std::size_t blockCount = CalculateBlockCount(valuesCount);
-        _mask = std::make_unique<ClientUpdateMaskType[]>(blockCount);
-        std::uninitialized_fill_n(&_mask[0], blockCount, 0);
+        ASSERT(valuesCount <= PLAYER_END);
     }
 
     void SetBit(uint32 bit)
@@ -108,7 +117,8 @@ private:
         return 1u << (bit % 32);
     }
 
-    std::unique_ptr<ClientUpdateMaskType[]> _mask;
+    // sized for the largest object, no allocation per update
+    std::array<ClientUpdateMaskType, (uint32(PLAYER_END) + CLIENT_UPDATE_MASK_BITS - 1) / CLIENT_UPDATE_MASK_BITS> _mask;
     uint32 _lastSetBit;
 };
 
@@ -28,6 +28,7 @@
 #include "BattlegroundMgr.h"
 #include "BattlegroundScore.h"
 #include "CellImpl.h"
+#include "CellSpatialIndex.h"
 #include "Channel.h"
 #include "ChannelMgr.h"
 #include "CharacterCache.h"
@@ -303,6 +304,7 @@ Player::Player(WorldSession* session): Unit(true)
     m_recall_instanceId = 0;
 
     m_seer = this;
+    m_visibilityRangeLimit = 0.0f;
 
     m_homebindMapId = 0;
     m_homebindAreaId = 0;
@@ -1766,6 +1768,7 @@ void Player::SetObjectScale(float scale)
     Unit::SetObjectScale(scale);
     SetFloatValue(UNIT_FIELD_BOUNDINGRADIUS, scale * DEFAULT_PLAYER_BOUNDING_RADIUS);
     SetFloatValue(UNIT_FIELD_COMBATREACH, scale * DEFAULT_PLAYER_COMBAT_REACH);
+    CellSpatialIndex::Update(this);
     if (IsInWorld())
         SendMovementSetCollisionHeight(GetCollisionHeight(), UPDATE_COLLISION_HEIGHT_SCALE);
 }
@@ -2035,11 +2038,13 @@ void Player::SetGameMaster(bool on)
         CombatStopWithPets();
 
         PhasingHandler::SetAlwaysVisible(GetPhaseShift(), true);
+        CellSpatialIndex::Update(this);
         m_serverSideVisibilityDetect.SetValue(SERVERSIDE_VISIBILITY_GM, GetSession()->GetSecurity());
     }
     else
     {
         PhasingHandler::SetAlwaysVisible(GetPhaseShift(), false);
+        CellSpatialIndex::Update(this);
 
         m_ExtraFlags &= ~ PLAYER_EXTRA_GM_ON;
         SetFactionForRace(getRace());
@@ -22598,10 +22603,13 @@ void Player::SendInitialVisiblePackets(Unit* target) const
 }
 
 template<class T>
-void Player::UpdateVisibilityOf(T* target, UpdateData& data, std::set<Unit*>& visibleNow)
+bool Player::UpdateVisibilityOf(T* target, UpdateData& data, std::set<Unit*>& visibleNow, bool onlyChanged /*= false*/)
 {
     if (HaveAtClient(target))
     {
+        if (onlyChanged && !IsVisibilityRecheckNeeded(target))
+            return true;
+
         if (!CanSeeOrDetect(target, false, true))
         {
             BeforeVisibilityDestroy<T>(target, this);
@@ -22616,28 +22624,32 @@ void Player::UpdateVisibilityOf(T* target, UpdateData& data, std::set<Unit*>& vi
             #ifdef TRINITY_DEBUG
                 TC_LOG_DEBUG("maps", "Object %u (Type: %u, Entry: %u) is out of range for player %u. Distance = %f", target->GetGUID().GetCounter(), target->GetTypeId(), target->GetEntry(), GetGUID().GetCounter(), GetDistance(target));
             #endif
+            return false;
         }
+
+        return true;
     }
-    else
+
+    if (CanSeeOrDetect(target, false, true))
     {
-        if (CanSeeOrDetect(target, false, true))
-        {
-            target->BuildCreateUpdateBlockForPlayer(&data, this);
-            UpdateVisibilityOf_helper(m_clientGUIDs, target, visibleNow);
+        target->BuildCreateUpdateBlockForPlayer(&data, this);
+        UpdateVisibilityOf_helper(m_clientGUIDs, target, visibleNow);
 
-            #ifdef TRINITY_DEBUG
-                TC_LOG_DEBUG("maps", "Object %u (Type: %u, Entry: %u) is visible now for player %u. Distance = %f", target->GetGUID().GetCounter(), target->GetTypeId(), target->GetEntry(), GetGUID().GetCounter(), GetDistance(target));
-            #endif
-        }
+        #ifdef TRINITY_DEBUG
+            TC_LOG_DEBUG("maps", "Object %u (Type: %u, Entry: %u) is visible now for player %u. Distance = %f", target->GetGUID().GetCounter(), target->GetTypeId(), target->GetEntry(), GetGUID().GetCounter(), GetDistance(target));
+        #endif
+        return true;
     }
+
+    return false;
 }
 
-template void Player::UpdateVisibilityOf(Player*        target, UpdateData& data, std::set<Unit*>& visibleNow);
-template void Player::UpdateVisibilityOf(Creature*      target, UpdateData& data, std::set<Unit*>& visibleNow);
-template void Player::UpdateVisibilityOf(Corpse*        target, UpdateData& data, std::set<Unit*>& visibleNow);
-template void Player::UpdateVisibilityOf(GameObject*    target, UpdateData& data, std::set<Unit*>& visibleNow);
-template void Player::UpdateVisibilityOf(DynamicObject* target, UpdateData& data, std::set<Unit*>& visibleNow);
-template void Player::UpdateVisibilityOf(AreaTrigger*   target, UpdateData& data, std::set<Unit*>& visibleNow);
+template bool Player::UpdateVisibilityOf(Player*        target, UpdateData& data, std::set<Unit*>& visibleNow, bool onlyChanged);
+template bool Player::UpdateVisibilityOf(Creature*      target, UpdateData& data, std::set<Unit*>& visibleNow, bool onlyChanged);
+template bool Player::UpdateVisibilityOf(Corpse*        target, UpdateData& data, std::set<Unit*>& visibleNow, bool onlyChanged);
+template bool Player::UpdateVisibilityOf(GameObject*    target, UpdateData& data, std::set<Unit*>& visibleNow, bool onlyChanged);
+template bool Player::UpdateVisibilityOf(DynamicObject* target, UpdateData& data, std::set<Unit*>& visibleNow, bool onlyChanged);
+template bool Player::UpdateVisibilityOf(AreaTrigger*   target, UpdateData& data, std::set<Unit*>& visibleNow, bool onlyChanged);
 
 void Player::UpdateObjectVisibility(bool forced)
 {
@@ -22646,7 +22658,10 @@ void Player::UpdateObjectVisibility(bool forced)
         return;
 
     if (!forced)
-        AddToNotify(NOTIFY_VISIBILITY_CHANGED);
+    {
+        SetVisibilityChanged();
+        AddToNotify(NOTIFY_VISIBILITY_CHANGED | NOTIFY_VISIBILITY_RECHECK_ALL);
+    }
     else
     {
         Unit::UpdateObjectVisibility(true);
@@ -22654,6 +22669,16 @@ void Player::UpdateObjectVisibility(bool forced)
     }
 }
 
+void Player::UpdateObjectVisibilityOnRelocation()
+{
+    if (!IsInWorld())
+        return;
+
+    // only the view point moved, the delayed notify may keep objects that did not change themselves
+    SetVisibilityChanged();
+    AddToNotify(NOTIFY_VISIBILITY_CHANGED);
+}
+
 void Player::UpdateVisibilityForPlayer()
 {
     // updates visibility of all objects around point of view for current player
@@ -22662,6 +22687,72 @@ void Player::UpdateVisibilityForPlayer()
     notifier.SendToSelf();   // send gathered data
 }
 
+bool Player::IsVisibilityRecheckNeeded(WorldObject const* target) const
+{
+    if (target->GetVisibilityChangeTime() >= m_visibilityUpdateTime)
+        return true;
+
+    // stealth detection and ghost sight depend on distance, vehicle accessories on their vehicle being seen
+    if (target->m_stealth.GetFlags() || isDead())
+        return true;
+
+    if (Unit const* unit = target->ToUnit())
+        if (unit->GetVehicleBase())
+            return true;
+
+    return !m_seer->IsWithinDist(target, GetSightRange(target), false);
+}
+
+bool Player::IsExemptFromVisibilityRangeLimit(WorldObject const* target) const
+{
+    // whatever the player fights or has selected must not vanish from the client
+    if (Unit const* unit = target->ToUnit())
+    {
+        if (GetVictim() == unit || GetTarget() == unit->GetGUID() || IsInCombatWith(unit))
+            return true;
+
+        if (getAttackers().count(const_cast<Unit*>(unit)))
+            return true;
+    }
+
+    if (Player const* player = target->ToPlayer())
+        return IsInSameRaidWith(player);
+
+    if (Creature const* creature = target->ToCreature())
+        return creature->isWorldBoss() || creature->IsDungeonBoss() || creature->GetCharmerOrOwnerGUID() == GetGUID();
+
+    return false;
+}
+
+void Player::UpdateVisibilityRangeLimit()
+{
+    uint32 const threshold = sWorld->getIntConfig(CONFIG_VISIBILITY_ADAPTIVE_THRESHOLD);
+    float const maxRange = GetMap()->GetVisibilityRange();
+    float const minRange = std::min(sWorld->getFloatConfig(CONFIG_VISIBILITY_ADAPTIVE_MIN_DISTANCE), maxRange);
+    if (!threshold)
+    {
+        m_visibilityRangeLimit = 0.0f;
+        return;
+    }
+
+    // objects at client grow with the covered area, the range that would hold threshold of them scales with the square root
+    float const range = m_visibilityRangeLimit > 0.0f ? std::min(m_visibilityRangeLimit, maxRange) : maxRange;
+    float wanted = maxRange;
+    if (!m_clientGUIDs.empty())
+        wanted = range * std::sqrt(float(threshold) / float(m_clientGUIDs.size()));
+
+    wanted = std::clamp(wanted, minRange, maxRange);
+
+    // shrink at once to bound the cost but ignore small dips, recover a few yards per pass so the edge does not flicker
+    constexpr float RecoveryStep = 5.0f;
+    if (wanted > range)
+        wanted = std::min(wanted, range + RecoveryStep);
+    else if (wanted > range * 0.9f)
+        wanted = range;
+
+    m_visibilityRangeLimit = wanted < maxRange ? wanted : 0.0f;
+}
+
 void Player::InitPrimaryProfessions()
 {
     SetFreePrimaryProfessions(sWorld->getIntConfig(CONFIG_MAX_PRIMARY_TRADE_SKILL));
@@ -2174,6 +2174,7 @@ class TC_GAME_API Player : public Unit, public GridObject<Player>
         void UpdateFallInformationIfNeed(MovementInfo const& minfo, uint16 opcode);
 
         WorldObject* m_seer;
+        float m_visibilityRangeLimit;
         void SetFallInformation(uint32 time, float z);
         void HandleFall(MovementInfo const& movementInfo);
         bool SetDisableGravity(bool disable, bool updateAnimTier = true) override;
@@ -2223,12 +2224,24 @@ class TC_GAME_API Player : public Unit, public GridObject<Player>
 
         void SendInitialVisiblePackets(Unit* target) const;
         void UpdateObjectVisibility(bool forced = true) override;
+        void UpdateObjectVisibilityOnRelocation();
         void UpdateVisibilityForPlayer();
         void UpdateVisibilityOf(WorldObject* target);
         void UpdateTriggerVisibility();
 
+        // Returns whether target is at client afterwards.
+        // With onlyChanged, targets already at client keep their state unless IsVisibilityRecheckNeeded
         template<class T>
-        void UpdateVisibilityOf(T* target, UpdateData& data, std::set<Unit*>& visibleNow);
+        bool UpdateVisibilityOf(T* target, UpdateData& data, std::set<Unit*>& visibleNow, bool onlyChanged = false);
+        bool IsVisibilityRecheckNeeded(WorldObject const* target) const;
+
+        // game time of the last finished VisibleNotifier pass
+        std::chrono::steady_clock::time_point m_visibilityUpdateTime;
+
+        // Sight range cap while crowded, 0 when not capped. See Visibility.Adaptive.Threshold
+        float GetVisibilityRangeLimit() const { return m_visibilityRangeLimit; }
+        bool IsExemptFromVisibilityRangeLimit(WorldObject const* target) const;
+        void UpdateVisibilityRangeLimit();
 
         uint8 m_forced_speed_changes[MAX_MOVE_TYPE];
 
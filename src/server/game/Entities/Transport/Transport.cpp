@@ -709,9 +709,12 @@ void Transport::BuildUpdate(UpdateDataMapType& data_map)
     if (players.isEmpty())
         return;
 
+    // sent to the whole map, most passengers and onlookers share one block
+    ValuesUpdateBlockCache sharedBlocks;
+    ValuesUpdateBlockCache* blocks = HasViewerDependentValuesUpdate(UPDATETYPE_VALUES) ? nullptr : &sharedBlocks;
     for (MapReference const& playerReference : players)
         if (playerReference.GetSource()->IsInPhase(this))
-            BuildFieldsUpdate(playerReference.GetSource(), data_map);
+            BuildFieldsUpdate(playerReference.GetSource(), data_map, blocks);
 
     ClearUpdateMask(true);
 }
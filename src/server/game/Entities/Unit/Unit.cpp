@@ -69,6 +69,7 @@
 #include "PlayerAI.h"
 #include "QuestDef.h"
 #include "ReputationMgr.h"
+#include "ReusableBuffer.h"
 #include "ScheduledChangeAI.h"
 #include "Spell.h"
 #include "SpellAuraEffects.h"
@@ -82,6 +83,7 @@
 #include "Totem.h"
 #include "Transport.h"
 #include "UnitAI.h"
+#include "UpdateData.h"
 #include "UpdateFieldFlags.h"
 #include "Util.h"
 #include "Vehicle.h"
@@ -375,6 +377,7 @@ Unit::Unit(bool isWorldObject) :
     _usedPowerTypes.fill(MAX_POWERS);
 
     _oldFactionId = 0;
+    _farCellMarkingTick = 0;
     _isWalkingBeforeCharm = false;
     _playHoverAnim = false;
 }
@@ -10609,26 +10612,21 @@ void Unit::UpdateReactives(uint32 p_time)
 
 Unit* Unit::SelectNearbyTarget(Unit* exclude, float dist) const
 {
-    std::list<Unit*> targets;
+    Trinity::ReusableBuffer<Unit*> targetsBuffer;
+    auto& targets = *targetsBuffer;
     Trinity::AnyUnfriendlyUnitInObjectRangeCheck u_check(this, this, dist);
     Trinity::UnitListSearcher<Trinity::AnyUnfriendlyUnitInObjectRangeCheck> searcher(this, targets, u_check);
     Cell::VisitAllObjects(this, searcher, dist);
 
-    // remove current target
-    if (GetVictim())
-        targets.remove(GetVictim());
-
-    if (exclude)
-        targets.remove(exclude);
-
-    // remove not LoS targets
-    for (std::list<Unit*>::iterator tIter = targets.begin(); tIter != targets.end();)
+    // remove current target, excluded target and not LoS targets
+    Unit* victim = GetVictim();
+    Trinity::Containers::EraseIf(targets, [this, victim, exclude](Unit* target)
     {
-        if (!IsWithinLOSInMap(*tIter) || (*tIter)->IsTotem() || (*tIter)->IsSpiritService() || (*tIter)->IsCritter())
-            targets.erase(tIter++);
-        else
-            ++tIter;
-    }
+        if (target == victim || target == exclude)
+            return true;
+
+        return !IsWithinLOSInMap(target) || target->IsTotem() || target->IsSpiritService() || target->IsCritter();
+    });
 
     // no appropriate targets
     if (targets.empty())
@@ -12190,7 +12188,10 @@ void Unit::OnPhaseChange()
 void Unit::UpdateObjectVisibility(bool forced)
 {
     if (!forced)
+    {
+        SetVisibilityChanged();
         AddToNotify(NOTIFY_VISIBILITY_CHANGED);
+    }
     else
     {
         WorldObject::UpdateObjectVisibility(true);
@@ -13954,7 +13955,8 @@ void Unit::BuildValuesUpdate(uint8 updateType, ByteBuffer* data, Player* target)
     if (!target)
         return;
 
-    ByteBuffer fieldBuffer;
+    UpdateBufferLease fieldBufferLease;
+    ByteBuffer& fieldBuffer = *fieldBufferLease;
 
     uint32 valCount = m_valuesCount;
 
@@ -13983,7 +13985,9 @@ void Unit::BuildValuesUpdate(uint8 updateType, ByteBuffer* data, Player* target)
         visibleFlag |= UF_FLAG_UNIT_ALL;
 
     Creature const* creature = ToCreature();
-    for (uint16 index = 0; index < valCount; ++index)
+    // special info fields and per caster aura states are sent whether changed or not
+    bool changesOnly = updateType == UPDATETYPE_VALUES && !(visibleFlag & UF_FLAG_SPECIAL_INFO) && !HasFlag(UNIT_FIELD_AURASTATE, PER_CASTER_AURA_STATE_MASK);
+    VisitValuesUpdateFields(valCount, changesOnly, [&](uint16 index)
     {
         if (_fieldNotifyFlags & flags[index] ||
             ((flags[index] & visibleFlag) & UF_FLAG_SPECIAL_INFO) ||
@@ -14113,12 +14117,44 @@ void Unit::BuildValuesUpdate(uint8 updateType, ByteBuffer* data, Player* target)
                 fieldBuffer << m_uint32Values[index];
             }
         }
-    }
+    });
 
     updateMask.AppendToPacket(data);
     data->append(fieldBuffer);
 }
 
+bool Unit::HasViewerDependentValuesUpdate(uint8 updateType) const
+{
+    // mirrors the per viewer rewrites of BuildValuesUpdate, display id, dynamic and npc flags are part of every update
+    if (HasFlag(UNIT_FIELD_AURASTATE, PER_CASTER_AURA_STATE_MASK))
+        return true;
+
+    if (IsFieldInValuesUpdate(updateType, UNIT_FIELD_FLAGS, UnitUpdateFieldFlags) && HasFlag(UNIT_FIELD_FLAGS, UNIT_FLAG_NOT_SELECTABLE))
+        return true;
+
+    if (IsFieldInValuesUpdate(updateType, UNIT_DYNAMIC_FLAGS, UnitUpdateFieldFlags) && HasFlag(UNIT_DYNAMIC_FLAGS, UNIT_DYNFLAG_LOOTABLE | UNIT_DYNFLAG_TRACK_UNIT))
+        return true;
+
+    if ((IsFieldInValuesUpdate(updateType, UNIT_FIELD_BYTES_2, UnitUpdateFieldFlags) || IsFieldInValuesUpdate(updateType, UNIT_FIELD_FACTIONTEMPLATE, UnitUpdateFieldFlags)) &&
+        IsControlledByPlayer() && sWorld->getBoolConfig(CONFIG_ALLOW_TWO_SIDE_INTERACTION_GROUP))
+        return true;
+
+    if (Creature const* creature = ToCreature())
+    {
+        if (IsFieldInValuesUpdate(updateType, UNIT_DYNAMIC_FLAGS, UnitUpdateFieldFlags) && creature->hasLootRecipient())
+            return true;
+
+        if (IsFieldInValuesUpdate(updateType, UNIT_NPC_FLAGS, UnitUpdateFieldFlags) && HasFlag(UNIT_NPC_FLAGS, UNIT_NPC_FLAG_SPELLCLICK | UNIT_NPC_FLAG_TRAINER_CLASS))
+            return true;
+
+        // gamemasters see the visible model of triggers, transformed or not
+        if (IsFieldInValuesUpdate(updateType, UNIT_FIELD_DISPLAYID, UnitUpdateFieldFlags) && (getTransForm() || creature->GetCreatureTemplate()->flags_extra & CREATURE_FLAG_EXTRA_TRIGGER))
+            return true;
+    }
+
+    return false;
+}
+
 void Unit::DestroyForPlayer(Player* target, bool /*onDeath = false*/) const
 {
     if (Battleground* bg = target->GetBattleground())
@@ -1516,6 +1516,9 @@ class TC_GAME_API Unit : public WorldObject
         SpellImmuneContainer m_spellImmune[MAX_SPELL_IMMUNITY];
         uint32 m_lastSanctuaryTime;
 
+        // false when already queued in this map tick, lets the map collect far units in player order without a set
+        bool QueueForFarCellMarking(uint32 mapTick) { if (_farCellMarkingTick == mapTick) return false; _farCellMarkingTick = mapTick; return true; }
+
         VisibleAuraMap const* GetVisibleAuras() { return &m_visibleAuras; }
         AuraApplication * GetVisibleAura(uint8 slot) const;
         void SetVisibleAura(uint8 slot, AuraApplication * aur);
@@ -1776,6 +1779,7 @@ class TC_GAME_API Unit : public WorldObject
         explicit Unit (bool isWorldObject);
 
         void BuildValuesUpdate(uint8 updatetype, ByteBuffer* data, Player* target) const override;
+        bool HasViewerDependentValuesUpdate(uint8 updateType) const override;
 
         void _UpdateSpells(uint32 time);
         void _DeleteRemovedAuras();
@@ -1914,6 +1918,7 @@ class TC_GAME_API Unit : public WorldObject
         bool m_duringRemoveFromWorld; // lock made to not add stuff after begining removing from world
 
         uint32 _oldFactionId;           ///< faction before charm
+        uint32 _farCellMarkingTick;     ///< map tick in which the cells around were last queued for marking
         bool _isWalkingBeforeCharm;     ///< Are we walking before we were charmed?
 
         bool _playHoverAnim;
@@ -16,6 +16,7 @@
  */
 
 #include "ObjectAccessor.h"
+#include "ConcurrentIndexTable.h"
 #include "Corpse.h"
 #include "Creature.h"
 #include "DynamicObject.h"
@@ -30,6 +31,18 @@
 #include "Transport.h"
 #include "World.h"
 
+namespace
+{
+    // Find is called from every map thread, it reads this table by guid counter without taking the lock.
+    // The map stays the container to iterate, both are written together under the lock
+    template<class T>
+    Trinity::ConcurrentIndexTable<T>& GetLookupTable()
+    {
+        static Trinity::ConcurrentIndexTable<T> _lookupTable;
+        return _lookupTable;
+    }
+}
+
 template<class T>
 void HashMapHolder<T>::Insert(T* o)
 {
@@ -39,6 +52,7 @@ void HashMapHolder<T>::Insert(T* o)
     std::unique_lock<std::shared_mutex> lock(*GetLock());
 
     GetContainer()[o->GetGUID()] = o;
+    GetLookupTable<T>().Set(o->GetGUID().GetCounter(), o);
 }
 
 template<class T>
@@ -47,15 +61,16 @@ void HashMapHolder<T>::Remove(T* o)
     std::unique_lock<std::shared_mutex> lock(*GetLock());
 
     GetContainer().erase(o->GetGUID());
+    GetLookupTable<T>().Clear(o->GetGUID().GetCounter());
 }
 
 template<class T>
 T* HashMapHolder<T>::Find(ObjectGuid guid)
 {
-    std::shared_lock<std::shared_mutex> lock(*GetLock());
+    if (!guid.IsPlayer())
+        return nullptr;
 
-    typename MapType::iterator itr = GetContainer().find(guid);
-    return (itr != GetContainer().end()) ? itr->second : nullptr;
+    return GetLookupTable<T>().Find(guid.GetCounter());
 }
 
 template<class T>
@@ -0,0 +1,72 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "CellOccupancy.h"
+#include "Errors.h"
+#include <bit>
+
+CellOccupancy::CellOccupancy() : _gridTypes()
+{
+}
+
+CellOccupancy::~CellOccupancy() = default;
+
+uint32 CellOccupancy::GetGridCount(uint32 gridX, uint32 gridY, uint16 type) const
+{
+    if (!(_gridTypes[gridX][gridY] & type))
+        return 0;
+
+    return _grids[gridX][gridY]->Counts[std::countr_zero(type)];
+}
+
+void CellOccupancy::Add(CellCoord const& cell, uint16 type)
+{
+    ASSERT(cell.IsCoordValid() && std::has_single_bit(type));
+
+    uint32 const gridX = cell.x_coord / MAX_NUMBER_OF_CELLS;
+    uint32 const gridY = cell.y_coord / MAX_NUMBER_OF_CELLS;
+    std::unique_ptr<GridCells>& grid = _grids[gridX][gridY];
+    if (!grid)
+        grid = std::make_unique<GridCells>();
+
+    uint32 const slot = GetCellSlot(cell);
+    uint32 const typeIndex = std::countr_zero(type);
+    if (!grid->CellCounts[slot][typeIndex]++)
+        grid->CellTypes[slot] |= type;
+
+    if (!grid->Counts[typeIndex]++)
+        _gridTypes[gridX][gridY] |= type;
+}
+
+void CellOccupancy::Remove(CellCoord const& cell, uint16 type)
+{
+    ASSERT(cell.IsCoordValid() && std::has_single_bit(type));
+
+    uint32 const gridX = cell.x_coord / MAX_NUMBER_OF_CELLS;
+    uint32 const gridY = cell.y_coord / MAX_NUMBER_OF_CELLS;
+    GridCells* grid = _grids[gridX][gridY].get();
+    ASSERT(grid);
+
+    uint32 const slot = GetCellSlot(cell);
+    uint32 const typeIndex = std::countr_zero(type);
+    ASSERT(grid->CellCounts[slot][typeIndex] && grid->Counts[typeIndex]);
+    if (!--grid->CellCounts[slot][typeIndex])
+        grid->CellTypes[slot] &= ~type;
+
+    if (!--grid->Counts[typeIndex])
+        _gridTypes[gridX][gridY] &= ~type;
+}
@@ -0,0 +1,96 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRINITY_CELL_OCCUPANCY_H
+#define TRINITY_CELL_OCCUPANCY_H
+
+#include "Define.h"
+#include "GridDefines.h"
+#include <array>
+#include <memory>
+#include <type_traits>
+
+// Occupancy types are GridMapTypeMask bits, shifted by CELL_OCCUPANCY_WORLD_SHIFT for objects of world containers
+constexpr uint32 CELL_OCCUPANCY_WORLD_SHIFT = 6;
+constexpr uint32 CELL_OCCUPANCY_TYPE_COUNT = 2 * CELL_OCCUPANCY_WORLD_SHIFT;
+
+/*
+    Which object types are present in every cell of a map, kept as one type mask per grid and one per cell.
+    Lookups read the grid mask first and only look at the cells of grids that have objects at all.
+    Maintained by CellSpatialIndex, which sees every object entering, leaving or switching container in a cell.
+*/
+class TC_GAME_API CellOccupancy
+{
+public:
+    CellOccupancy();
+    ~CellOccupancy();
+
+    CellOccupancy(CellOccupancy const&) = delete;
+    CellOccupancy& operator=(CellOccupancy const&) = delete;
+
+    // type is a single occupancy type bit
+    void Add(CellCoord const& cell, uint16 type);
+    void Remove(CellCoord const& cell, uint16 type);
+
+    uint16 GetGridTypes(uint32 gridX, uint32 gridY) const { return _gridTypes[gridX][gridY]; }
+
+    // Number of objects of a single occupancy type in the grid
+    uint32 GetGridCount(uint32 gridX, uint32 gridY, uint16 type) const;
+
+    uint16 GetCellTypes(CellCoord const& cell) const
+    {
+        uint32 const gridX = cell.x_coord / MAX_NUMBER_OF_CELLS;
+        uint32 const gridY = cell.y_coord / MAX_NUMBER_OF_CELLS;
+        if (!_gridTypes[gridX][gridY])
+            return 0;
+
+        return _grids[gridX][gridY]->CellTypes[GetCellSlot(cell)];
+    }
+
+    // Occupancy types a visit of CONTAINER looks at, mapTypeMask limits the GridMapTypeMask bits
+    template<class CONTAINER>
+    static uint16 GetContainerTypes(uint32 mapTypeMask)
+    {
+        if constexpr (std::is_same_v<CONTAINER, WorldTypeMapContainer>)
+            return uint16((mapTypeMask & GRID_MAP_TYPE_MASK_ALL) << CELL_OCCUPANCY_WORLD_SHIFT);
+        else if constexpr (std::is_same_v<CONTAINER, GridTypeMapContainer>)
+            return uint16(mapTypeMask & GRID_MAP_TYPE_MASK_ALL);
+        else
+            return uint16((GRID_MAP_TYPE_MASK_ALL << CELL_OCCUPANCY_WORLD_SHIFT) | GRID_MAP_TYPE_MASK_ALL);
+    }
+
+private:
+    static constexpr uint32 CellsPerGrid = MAX_NUMBER_OF_CELLS * MAX_NUMBER_OF_CELLS;
+
+    struct GridCells
+    {
+        std::array<uint16, CellsPerGrid> CellTypes = { };
+        std::array<std::array<uint16, CELL_OCCUPANCY_TYPE_COUNT>, CellsPerGrid> CellCounts = { };
+        std::array<uint32, CELL_OCCUPANCY_TYPE_COUNT> Counts = { };
+    };
+
+    static uint32 GetCellSlot(CellCoord const& cell)
+    {
+        return (cell.x_coord % MAX_NUMBER_OF_CELLS) * MAX_NUMBER_OF_CELLS + cell.y_coord % MAX_NUMBER_OF_CELLS;
+    }
+
+    uint16 _gridTypes[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
+    // allocated on first use and kept, at most one per grid of the map
+    std::unique_ptr<GridCells> _grids[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
+};
+
+#endif // TRINITY_CELL_OCCUPANCY_H
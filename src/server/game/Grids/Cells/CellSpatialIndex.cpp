@@ -0,0 +1,161 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "CellSpatialIndex.h"
+#include "CellOccupancy.h"
+#include "Errors.h"
+#include "Object.h"
+#include "PhaseShift.h"
+
+namespace
+{
+    uint32 GetIndexedTypeMask(WorldObject const* object)
+    {
+        uint32 typeMask = 0;
+        for (uint16 mask : { TYPEMASK_UNIT, TYPEMASK_PLAYER, TYPEMASK_GAMEOBJECT, TYPEMASK_DYNAMICOBJECT, TYPEMASK_CORPSE, TYPEMASK_AREATRIGGER })
+            if (object->isType(mask))
+                typeMask |= mask;
+
+        return typeMask;
+    }
+
+    uint16 GetOccupancyType(WorldObject const* object)
+    {
+        uint16 mapType = 0;
+        switch (object->GetTypeId())
+        {
+            case TYPEID_PLAYER: mapType = GRID_MAP_TYPE_MASK_PLAYER; break;
+            case TYPEID_UNIT: mapType = GRID_MAP_TYPE_MASK_CREATURE; break;
+            case TYPEID_GAMEOBJECT: mapType = GRID_MAP_TYPE_MASK_GAMEOBJECT; break;
+            case TYPEID_DYNAMICOBJECT: mapType = GRID_MAP_TYPE_MASK_DYNAMICOBJECT; break;
+            case TYPEID_CORPSE: mapType = GRID_MAP_TYPE_MASK_CORPSE; break;
+            case TYPEID_AREATRIGGER: mapType = GRID_MAP_TYPE_MASK_AREATRIGGER; break;
+            default: break;
+        }
+
+        return object->IsWorldObject() ? uint16(mapType << CELL_OCCUPANCY_WORLD_SHIFT) : mapType;
+    }
+}
+
+CellSpatialIndex::~CellSpatialIndex()
+{
+    // objects outliving their cell, corpses of unloaded grids, must not point here anymore
+    for (std::size_t row = 0; row < _objects.size(); ++row)
+    {
+        _objects[row]->_cellIndex = nullptr;
+        if (_occupancy && _occupancyTypes[row])
+            _occupancy->Remove(CellCoord(_cellX, _cellY), _occupancyTypes[row]);
+    }
+}
+
+void CellSpatialIndex::AttachOccupancy(CellOccupancy* occupancy, uint32 cellX, uint32 cellY)
+{
+    ASSERT(!_occupancy && _objects.empty());
+    _occupancy = occupancy;
+    _cellX = cellX;
+    _cellY = cellY;
+}
+
+void CellSpatialIndex::Insert(WorldObject* object)
+{
+    Remove(object);
+
+    object->_cellIndex = this;
+    object->_cellIndexRow = uint32(_objects.size());
+
+    _positionX.emplace_back();
+    _positionY.emplace_back();
+    _combatReach.emplace_back();
+    _typeMasks.emplace_back();
+    _containers.emplace_back();
+    _phaseSummaries.emplace_back();
+    _occupancyTypes.emplace_back();
+    _objects.emplace_back();
+
+    WriteRow(object->_cellIndexRow, object);
+}
+
+void CellSpatialIndex::Update(WorldObject* object)
+{
+    if (CellSpatialIndex* index = object->_cellIndex)
+        index->WriteRow(object->_cellIndexRow, object);
+}
+
+void CellSpatialIndex::Remove(WorldObject* object)
+{
+    if (CellSpatialIndex* index = object->_cellIndex)
+    {
+        index->EraseRow(object->_cellIndexRow);
+        object->_cellIndex = nullptr;
+    }
+}
+
+void CellSpatialIndex::WriteRow(uint32 row, WorldObject* object)
+{
+    _positionX[row] = object->GetPositionX();
+    _positionY[row] = object->GetPositionY();
+    _combatReach[row] = object->GetCombatReach();
+    _typeMasks[row] = GetIndexedTypeMask(object);
+    _containers[row] = object->IsWorldObject() ? CELL_INDEX_WORLD_CONTAINER : CELL_INDEX_GRID_CONTAINER;
+    _phaseSummaries[row] = object->GetPhaseShift().GetSummary();
+    _objects[row] = object;
+
+    // new rows start without a type, objects switching between grid and world container change theirs
+    uint16 occupancyType = GetOccupancyType(object);
+    if (_occupancyTypes[row] != occupancyType)
+    {
+        if (_occupancy)
+        {
+            if (_occupancyTypes[row])
+                _occupancy->Remove(CellCoord(_cellX, _cellY), _occupancyTypes[row]);
+            if (occupancyType)
+                _occupancy->Add(CellCoord(_cellX, _cellY), occupancyType);
+        }
+
+        _occupancyTypes[row] = occupancyType;
+    }
+}
+
+void CellSpatialIndex::EraseRow(uint32 row)
+{
+    if (_occupancy && _occupancyTypes[row])
+        _occupancy->Remove(CellCoord(_cellX, _cellY), _occupancyTypes[row]);
+
+    // swap with the last row so the arrays stay dense
+    uint32 last = uint32(_objects.size() - 1);
+    if (row != last)
+    {
+        _positionX[row] = _positionX[last];
+        _positionY[row] = _positionY[last];
+        _combatReach[row] = _combatReach[last];
+        _typeMasks[row] = _typeMasks[last];
+        _containers[row] = _containers[last];
+        _phaseSummaries[row] = _phaseSummaries[last];
+        _occupancyTypes[row] = _occupancyTypes[last];
+        _objects[row] = _objects[last];
+        _objects[row]->_cellIndexRow = row;
+    }
+
+    _positionX.pop_back();
+    _positionY.pop_back();
+    _combatReach.pop_back();
+    _typeMasks.pop_back();
+    _containers.pop_back();
+    _phaseSummaries.pop_back();
+    _occupancyTypes.pop_back();
+    _objects.pop_back();
+}
@@ -0,0 +1,117 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRINITY_CELL_SPATIAL_INDEX_H
+#define TRINITY_CELL_SPATIAL_INDEX_H
+
+#include "Define.h"
+#include <algorithm>
+#include <vector>
+
+class CellOccupancy;
+class WorldObject;
+
+enum CellIndexContainer : uint8
+{
+    CELL_INDEX_GRID_CONTAINER   = 0x1,
+    CELL_INDEX_WORLD_CONTAINER  = 0x2,
+    CELL_INDEX_ALL_CONTAINERS   = CELL_INDEX_GRID_CONTAINER | CELL_INDEX_WORLD_CONTAINER
+};
+
+constexpr uint32 CELL_INDEX_ANY_PHASE = 0xFFFFFFFF;
+
+/*
+    Packed rows of everything a broad phase range check needs, one index per cell next to its GridRefManager lists.
+    Searches scan these contiguous arrays and only dereference the objects whose row passed.
+    Rows are added and removed together with the object entering and leaving the cell (Map::AddToGrid, Map::RemoveFromMap)
+    and refreshed by Update, which runs for every relocation through WorldObject::UpdatePositionData.
+    Row changes are mirrored to the CellOccupancy of the map once attached.
+*/
+class TC_GAME_API CellSpatialIndex
+{
+public:
+    CellSpatialIndex() : _occupancy(nullptr), _cellX(0), _cellY(0) { }
+    ~CellSpatialIndex();
+
+    CellSpatialIndex(CellSpatialIndex const&) = delete;
+    CellSpatialIndex& operator=(CellSpatialIndex const&) = delete;
+
+    // Reports the objects of this index, global cell coordinates, as present in occupancy from now on
+    void AttachOccupancy(CellOccupancy* occupancy, uint32 cellX, uint32 cellY);
+
+    // Moves the object to this index, out of the one it was in
+    void Insert(WorldObject* object);
+
+    // Refresh or drop the row of an object in whichever index holds it, no-op for objects in none
+    static void Update(WorldObject* object);
+    static void Remove(WorldObject* object);
+
+    std::size_t Size() const { return _objects.size(); }
+
+    // Calls visit(WorldObject*) for every object whose combat reach touches the circle, matching all masks,
+    // phaseSummary is a PhaseShift::GetSummary() or CELL_INDEX_ANY_PHASE.
+    // The visitor must not add, remove or move objects of this cell.
+    template<typename Visitor>
+    void Visit(float x, float y, float radius, uint32 typeMask, uint8 containerMask, uint32 phaseSummary, Visitor&& visit) const
+    {
+        constexpr std::size_t ChunkSize = 64;
+        WorldObject* matches[ChunkSize];
+
+        for (std::size_t begin = 0; begin < _objects.size(); begin += ChunkSize)
+        {
+            std::size_t const end = std::min(begin + ChunkSize, _objects.size());
+            std::size_t count = 0;
+
+            // branch free pass over the packed rows, objects are not touched yet
+            for (std::size_t i = begin; i < end; ++i)
+            {
+                float const dx = _positionX[i] - x;
+                float const dy = _positionY[i] - y;
+                float const range = radius + _combatReach[i];
+                bool const match = (dx * dx + dy * dy <= range * range)
+                    & ((_typeMasks[i] & typeMask) != 0)
+                    & ((_containers[i] & containerMask) != 0)
+                    & ((_phaseSummaries[i] & phaseSummary) != 0);
+
+                matches[count] = _objects[i];
+                count += match;
+            }
+
+            for (std::size_t i = 0; i < count; ++i)
+                visit(matches[i]);
+        }
+    }
+
+private:
+    void WriteRow(uint32 row, WorldObject* object);
+    void EraseRow(uint32 row);
+
+    std::vector<float> _positionX;
+    std::vector<float> _positionY;
+    std::vector<float> _combatReach;
+    std::vector<uint32> _typeMasks;
+    std::vector<uint8> _containers;
+    std::vector<uint32> _phaseSummaries;
+    std::vector<uint16> _occupancyTypes;
+    std::vector<WorldObject*> _objects;
+
+    CellOccupancy* _occupancy;
+    uint32 _cellX;
+    uint32 _cellY;
+};
+
+#endif // TRINITY_CELL_SPATIAL_INDEX_H
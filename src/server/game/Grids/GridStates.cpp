@@ -63,3 +63,8 @@ void RemovalState::Update(Map& map, NGridType& grid, GridInfo& info, uint32 diff
         }
     }
 }
+
+void RetainedState::Update(Map&, NGridType&, GridInfo&, uint32) const
+{
+    // left for Map::TrimRetainedGrids or an active object coming back
+}
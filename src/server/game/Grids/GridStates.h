@@ -53,4 +53,10 @@ class TC_GAME_API RemovalState : public GridState
     public:
         void Update(Map &, NGridType &, GridInfo &, uint32 t_diff) const override;
 };
+
+class TC_GAME_API RetainedState : public GridState
+{
+    public:
+        void Update(Map &, NGridType &, GridInfo &, uint32 t_diff) const override;
+};
 #endif
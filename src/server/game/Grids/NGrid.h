@@ -21,6 +21,7 @@
 /** NGrid is nothing more than a wrapper of the Grid with an NxN cells
  */
 
+#include "CellSpatialIndex.h"
 #include "Grid.h"
 #include "GridReference.h"
 #include "Timer.h"
@@ -57,7 +58,8 @@ typedef enum
     GRID_STATE_ACTIVE = 1,
     GRID_STATE_IDLE = 2,
     GRID_STATE_REMOVAL= 3,
-    MAX_GRID_STATE = 4
+    GRID_STATE_RETAINED = 4,                                // unload postponed, objects kept but not updated
+    MAX_GRID_STATE = 5
 } grid_state_t;
 
 template
@@ -88,6 +90,25 @@ class NGrid
             return i_cells[x][y];
         }
 
+        CellSpatialIndex& GetCellIndex(uint32 x, uint32 y)
+        {
+            ASSERT(x < N && y < N);
+            return i_cellIndexes[x][y];
+        }
+
+        CellSpatialIndex const& GetCellIndex(uint32 x, uint32 y) const
+        {
+            ASSERT(x < N && y < N);
+            return i_cellIndexes[x][y];
+        }
+
+        void AttachCellOccupancy(CellOccupancy* occupancy)
+        {
+            for (uint32 x = 0; x < N; ++x)
+                for (uint32 y = 0; y < N; ++y)
+                    i_cellIndexes[x][y].AttachOccupancy(occupancy, uint32(i_x) * N + x, uint32(i_y) * N + y);
+        }
+
         uint32 GetGridId(void) const { return i_gridId; }
         void SetGridId(const uint32 id) { i_gridId = id; }
         grid_state_t GetGridState(void) const { return i_cellstate; }
@@ -180,6 +201,7 @@ class NGrid
         int32 i_y;
         grid_state_t i_cellstate;
         GridType i_cells[N][N];
+        CellSpatialIndex i_cellIndexes[N][N];
         bool i_GridObjectDataLoaded;
 };
 #endif
@@ -17,6 +17,7 @@
 
 #include "GridNotifiers.h"
 #include "GridNotifiersImpl.h"
+#include "GameTime.h"
 #include "WorldPacket.h"
 #include "WorldSession.h"
 #include "UpdateData.h"
@@ -28,15 +29,32 @@ using namespace Trinity;
 
 void VisibleNotifier::SendToSelf()
 {
-    // at this moment i_clientGUIDs have guids that not iterate at grid level checks
+    i_player.m_visibilityUpdateTime = GameTime::GetGameTimeSteadyPoint();
+
+    // everything at client that was not visited is out of range, usually nothing is left which is cheap to confirm
+    bool const allVisited = i_visited.size() == i_player.m_clientGUIDs.size()
+        && std::all_of(i_visited.begin(), i_visited.end(), [this](ObjectGuid const& guid) { return i_player.m_clientGUIDs.count(guid) != 0; });
+
+    std::vector<ObjectGuid> notVisited;
+    if (!allVisited)
+    {
+        std::sort(i_visited.begin(), i_visited.end());
+        for (ObjectGuid const& guid : i_player.m_clientGUIDs)
+            if (!std::binary_search(i_visited.begin(), i_visited.end(), guid))
+                notVisited.push_back(guid);
+    }
+
+    // at this moment notVisited have guids that not iterate at grid level checks
     // but exist one case when this possible and object not out of range: transports
     if (Transport* transport = dynamic_cast<Transport*>(i_player.GetTransport()))
     {
         for (Transport::PassengerSet::const_iterator itr = transport->GetPassengers().begin(); itr != transport->GetPassengers().end(); ++itr)
         {
-            if (vis_guids.find((*itr)->GetGUID()) != vis_guids.end())
+            auto notVisitedItr = std::find(notVisited.begin(), notVisited.end(), (*itr)->GetGUID());
+            if (notVisitedItr != notVisited.end())
             {
-                vis_guids.erase((*itr)->GetGUID());
+                *notVisitedItr = notVisited.back();
+                notVisited.pop_back();
 
                 switch ((*itr)->GetTypeId())
                 {
@@ -46,7 +64,7 @@ void VisibleNotifier::SendToSelf()
                     case TYPEID_PLAYER:
                         i_player.UpdateVisibilityOf((*itr)->ToPlayer(), i_data, i_visibleNow);
                         if (!(*itr)->isNeedNotify(NOTIFY_VISIBILITY_CHANGED))
-                            (*itr)->ToPlayer()->UpdateVisibilityOf(&i_player);
+                            UpdateVisibilityOfSelf((*itr)->ToPlayer());
                         break;
                     case TYPEID_UNIT:
                         i_player.UpdateVisibilityOf((*itr)->ToCreature(), i_data, i_visibleNow);
@@ -64,7 +82,7 @@ void VisibleNotifier::SendToSelf()
         }
     }
 
-    for (auto it = vis_guids.begin(); it != vis_guids.end(); ++it)
+    for (auto it = notVisited.begin(); it != notVisited.end(); ++it)
     {
         i_player.m_clientGUIDs.erase(*it);
         i_data.AddOutOfRangeGUID(*it);
@@ -73,21 +91,33 @@ void VisibleNotifier::SendToSelf()
         {
             Player* player = ObjectAccessor::FindPlayer(*it);
             if (player && !player->isNeedNotify(NOTIFY_VISIBILITY_CHANGED))
-                player->UpdateVisibilityOf(&i_player);
+                UpdateVisibilityOfSelf(player);
         }
     }
 
+    // with the objects now at client known, size the sight range for the next pass
+    i_player.UpdateVisibilityRangeLimit();
+
     if (!i_data.HasData())
         return;
 
-    WorldPacket packet;
-    i_data.BuildPacket(&packet);
-    i_player.SendDirectMessage(&packet);
+    std::vector<WorldPacket> packets;
+    i_data.BuildPackets(packets, &i_player);
+    for (WorldPacket const& packet : packets)
+        i_player.SendDirectMessage(&packet);
 
     for (std::set<Unit*>::const_iterator it = i_visibleNow.begin(); it != i_visibleNow.end(); ++it)
         i_player.SendInitialVisiblePackets(*it);
 }
 
+void VisibleNotifier::UpdateVisibilityOfSelf(Player* player)
+{
+    if (i_deferred)
+        i_deferred->PlayerVisibility.emplace_back(player, &i_player);
+    else
+        player->UpdateVisibilityOf(&i_player);
+}
+
 void VisibleChangesNotifier::Visit(PlayerMapType &m)
 {
     for (PlayerMapType::iterator iter = m.begin(); iter != m.end(); ++iter)
@@ -149,14 +179,12 @@ void PlayerRelocationNotifier::Visit(PlayerMapType &m)
     {
         Player* player = iter->GetSource();
 
-        vis_guids.erase(player->GetGUID());
-
-        i_player.UpdateVisibilityOf(player, i_data, i_visibleNow);
+        UpdateVisibilityOf(player);
 
         if (player->m_seer->isNeedNotify(NOTIFY_VISIBILITY_CHANGED))
             continue;
 
-        player->UpdateVisibilityOf(&i_player);
+        UpdateVisibilityOfSelf(player);
     }
 }
 
@@ -168,12 +196,15 @@ void PlayerRelocationNotifier::Visit(CreatureMapType &m)
     {
         Creature* c = iter->GetSource();
 
-        vis_guids.erase(c->GetGUID());
-
-        i_player.UpdateVisibilityOf(c, i_data, i_visibleNow);
+        UpdateVisibilityOf(c);
 
         if (relocated_for_ai && !c->isNeedNotify(NOTIFY_VISIBILITY_CHANGED))
-            CreatureUnitRelocationWorker(c, &i_player);
+        {
+            if (i_deferred)
+                i_deferred->AIRelocations.emplace_back(c, &i_player);
+            else
+                CreatureUnitRelocationWorker(c, &i_player);
+        }
     }
 }
 
@@ -213,6 +244,13 @@ void DelayedUnitRelocation::Visit(CreatureMapType &m)
         if (!unit->isNeedNotify(NOTIFY_VISIBILITY_CHANGED))
             continue;
 
+        // updates the visibility of every player around, left to the map thread
+        if (i_deferred)
+        {
+            i_deferred->CreatureRelocations.push_back(unit);
+            continue;
+        }
+
         CreatureRelocationNotifier relocate(*unit);
 
         TypeContainerVisitor<CreatureRelocationNotifier, WorldTypeMapContainer > c2world_relocation(relocate);
@@ -236,12 +274,53 @@ void DelayedUnitRelocation::Visit(PlayerMapType &m)
         if (player != viewPoint && !viewPoint->IsPositionValid())
             continue;
 
-        PlayerRelocationNotifier relocate(*player);
-        Cell::VisitAllObjects(viewPoint, relocate, i_radius, false);
+        // far sight, mind control and the like see objects of other regions
+        if (i_deferred && player != viewPoint)
+        {
+            i_deferred->PlayerRelocations.push_back(player);
+            continue;
+        }
+
+        // a view point that only moved keeps the objects at client that did not change themselves
+        PlayerRelocationNotifier relocate(*player, player == viewPoint && !player->isNeedNotify(NOTIFY_VISIBILITY_RECHECK_ALL), i_deferred);
+        // grids must not be loaded while other grids are notified in parallel
+        Cell::VisitAllObjects(viewPoint, relocate, i_radius, i_deferred != nullptr);
         relocate.SendToSelf();
     }
 }
 
+void DeferredRelocationWork::Run(float radius)
+{
+    for (Player* player : PlayerRelocations)
+    {
+        PlayerRelocationNotifier relocate(*player, false, nullptr);
+        Cell::VisitAllObjects(player->m_seer, relocate, radius);
+        relocate.SendToSelf();
+    }
+
+    for (Creature* creature : CreatureRelocations)
+    {
+        CreatureRelocationNotifier relocate(*creature);
+        Cell::VisitAllObjects(creature, relocate, radius);
+    }
+
+    // notify flags were already checked when queued, they stay as they are until the map resets them
+    for (std::pair<Player*, Player*> const& visibility : PlayerVisibility)
+        visibility.first->UpdateVisibilityOf(visibility.second);
+
+    for (std::pair<Player*, Creature*> const& visibility : PetVisibility)
+        visibility.first->UpdateVisibilityOf(visibility.second);
+
+    for (std::pair<Creature*, Unit*> const& relocation : AIRelocations)
+        CreatureUnitRelocationWorker(relocation.first, relocation.second);
+
+    PlayerRelocations.clear();
+    CreatureRelocations.clear();
+    PetVisibility.clear();
+    PlayerVisibility.clear();
+    AIRelocations.clear();
+}
+
 void AIRelocationNotifier::Visit(CreatureMapType &m)
 {
     for (CreatureMapType::iterator iter = m.begin(); iter != m.end(); ++iter)
@@ -408,6 +487,25 @@ void ObjectUpdater::Visit(GridRefManager<T> &m)
             iter->GetSource()->Update(i_timeDiff);
 }
 
+void ObjectUpdater::Visit(CreatureMapType &m)
+{
+    for (CreatureMapType::iterator iter = m.begin(); iter != m.end(); ++iter)
+    {
+        Creature* creature = iter->GetSource();
+        if (!creature->IsInWorld())
+            continue;
+
+        creature->SetFarFromPlayers(i_far);
+
+        // counted on the visits of the creature's cell, staggered cells are not visited on every tick
+        uint32 period = i_far ? std::max(i_bucketCount, i_farInterval) : i_bucketCount;
+        if (period > 1 && creature->CanSkipUpdates() && creature->SkipUpdate(period, i_timeDiff))
+            continue;
+
+        creature->Update(creature->TakeSkippedUpdateTime(i_timeDiff));
+    }
+}
+
 bool AnyDeadUnitObjectInRangeCheck::operator()(Player* u)
 {
     return !u->IsAlive() && !u->HasAuraType(SPELL_AURA_GHOST) && i_searchObj->IsWithinDistInMap(u, i_range);
@@ -438,7 +536,6 @@ bool AnyDeadUnitSpellTargetInRangeCheck::operator()(Creature* u)
     return AnyDeadUnitObjectInRangeCheck::operator()(u) && WorldObjectSpellTargetCheck::operator()(u);
 }
 
-template void ObjectUpdater::Visit<Creature>(CreatureMapType&);
 template void ObjectUpdater::Visit<GameObject>(GameObjectMapType&);
 template void ObjectUpdater::Visit<DynamicObject>(DynamicObjectMapType&);
 template void ObjectUpdater::Visit<AreaTrigger>(AreaTriggerMapType &);
@@ -31,16 +31,55 @@
 
 namespace Trinity
 {
+    /*
+        Relocation notify work that changes more than the relocated player itself,
+        collected while grids are notified in parallel and run by the map thread afterwards.
+    */
+    struct TC_GAME_API DeferredRelocationWork
+    {
+        std::vector<Player*> PlayerRelocations;                     // players whose view point is not themselves, it may be in another region
+        std::vector<Creature*> CreatureRelocations;                 // CreatureRelocationNotifier around each creature
+        std::vector<std::pair<Player*, Creature*>> PetVisibility;   // first updates its visibility of its pet, which may remove the pet
+        std::vector<std::pair<Player*, Player*>> PlayerVisibility;  // first updates its visibility of second
+        std::vector<std::pair<Creature*, Unit*>> AIRelocations;     // first may notice second moving in line of sight
+
+        void Run(float radius);
+    };
+
     struct TC_GAME_API VisibleNotifier
     {
         Player &i_player;
         UpdateData i_data;
         std::set<Unit*> i_visibleNow;
-        GuidUnorderedSet vis_guids;
+        std::vector<ObjectGuid> i_visited;                  // visited objects that are at client after the pass
+        bool i_onlyChanged;
+        DeferredRelocationWork* i_deferred;
 
-        VisibleNotifier(Player &player) : i_player(player), i_data(player.GetMapId()), vis_guids(player.m_clientGUIDs) { }
+        VisibleNotifier(Player &player, bool onlyChanged = false, DeferredRelocationWork* deferred = nullptr) : i_player(player), i_data(player.GetMapId()),
+            i_onlyChanged(onlyChanged), i_deferred(deferred) { }
         template<class T> void Visit(GridRefManager<T> &m);
         void SendToSelf(void);
+
+        // player updates its visibility of i_player, now or in the deferred pass
+        void UpdateVisibilityOfSelf(Player* player);
+
+        template<class T>
+        void UpdateVisibilityOf(T* target)
+        {
+            if constexpr (std::is_same_v<T, Creature>)
+            {
+                if (i_deferred && target->GetGUID() == i_player.GetPetGUID())
+                {
+                    i_deferred->PetVisibility.emplace_back(&i_player, target);
+                    if (i_player.HaveAtClient(target))
+                        i_visited.push_back(target->GetGUID());
+                    return;
+                }
+            }
+
+            if (i_player.UpdateVisibilityOf(target, i_data, i_visibleNow, i_onlyChanged) && target->GetGUID() != i_player.GetGUID())
+                i_visited.push_back(target->GetGUID());
+        }
     };
 
     struct VisibleChangesNotifier
@@ -56,7 +95,7 @@ namespace Trinity
 
     struct TC_GAME_API PlayerRelocationNotifier : public VisibleNotifier
     {
-        PlayerRelocationNotifier(Player &player) : VisibleNotifier(player) { }
+        PlayerRelocationNotifier(Player &player, bool onlyChanged, DeferredRelocationWork* deferred) : VisibleNotifier(player, onlyChanged, deferred) { }
 
         template<class T> void Visit(GridRefManager<T> &m) { VisibleNotifier::Visit(m); }
         void Visit(CreatureMapType &);
@@ -78,8 +117,9 @@ namespace Trinity
         Cell &cell;
         CellCoord &p;
         const float i_radius;
-        DelayedUnitRelocation(Cell &c, CellCoord &pair, Map &map, float radius) :
-            i_map(map), cell(c), p(pair), i_radius(radius) { }
+        DeferredRelocationWork* i_deferred;
+        DelayedUnitRelocation(Cell &c, CellCoord &pair, Map &map, float radius, DeferredRelocationWork* deferred = nullptr) :
+            i_map(map), cell(c), p(pair), i_radius(radius), i_deferred(deferred) { }
         template<class T> void Visit(GridRefManager<T> &) { }
         void Visit(CreatureMapType &);
         void Visit(PlayerMapType   &);
@@ -178,8 +218,13 @@ namespace Trinity
     struct ObjectUpdater
     {
         uint32 i_timeDiff;
-        explicit ObjectUpdater(const uint32 diff) : i_timeDiff(diff) { }
+        uint32 i_bucketCount;                               // idle creatures are updated once per this many visits of their cell
+        uint32 i_farInterval;                               // idle creatures far from players are updated once per this many visits
+        bool i_far;                                         // set per visited cell
+        explicit ObjectUpdater(const uint32 diff, uint32 bucketCount = 1, uint32 farInterval = 1)
+            : i_timeDiff(diff), i_bucketCount(bucketCount), i_farInterval(farInterval), i_far(false) { }
         template<class T> void Visit(GridRefManager<T> &m);
+        void Visit(CreatureMapType &m);
         void Visit(PlayerMapType &) { }
         void Visit(CorpseMapType &) { }
     };
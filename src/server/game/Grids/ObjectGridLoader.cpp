@@ -86,9 +86,10 @@ void ObjectGridLoader::SetObjectCell(MapObject* obj, CellCoord const& cellCoord)
 }
 
 template <class T>
-void AddObjectHelper(CellCoord &cell, GridRefManager<T> &m, uint32 &count, Map* map, T *obj)
+void AddObjectHelper(CellCoord &cell, GridRefManager<T> &m, CellSpatialIndex& index, uint32 &count, Map* map, T *obj)
 {
     obj->AddToGrid(m);
+    index.Insert(obj);
     ObjectGridLoader::SetObjectCell(obj, cell);
     obj->AddToWorld();
 
@@ -99,7 +100,7 @@ void AddObjectHelper(CellCoord &cell, GridRefManager<T> &m, uint32 &count, Map*
 }
 
 template <class T>
-void LoadHelper(CellGuidSet const& guid_set, CellCoord &cell, GridRefManager<T> &m, uint32 &count, Map* map)
+void LoadHelper(CellGuidSet const& guid_set, CellCoord &cell, GridRefManager<T> &m, CellSpatialIndex& index, uint32 &count, Map* map)
 {
     for (CellGuidSet::const_iterator i_guid = guid_set.begin(); i_guid != guid_set.end(); ++i_guid)
     {
@@ -115,7 +116,7 @@ void LoadHelper(CellGuidSet const& guid_set, CellCoord &cell, GridRefManager<T>
             delete obj;
             continue;
         }
-        AddObjectHelper(cell, m, count, map, obj);
+        AddObjectHelper(cell, m, index, count, map, obj);
     }
 }
 
@@ -123,14 +124,14 @@ void ObjectGridLoader::Visit(GameObjectMapType &m)
 {
     CellCoord cellCoord = i_cell.GetCellCoord();
     if (CellObjectGuids const* cell_guids = sObjectMgr->GetCellObjectGuids(i_map->GetId(), i_map->GetSpawnMode(), cellCoord.GetId()))
-        LoadHelper(cell_guids->gameobjects, cellCoord, m, i_gameObjects, i_map);
+        LoadHelper(cell_guids->gameobjects, cellCoord, m, i_grid.GetCellIndex(i_cell.CellX(), i_cell.CellY()), i_gameObjects, i_map);
 }
 
 void ObjectGridLoader::Visit(CreatureMapType &m)
 {
     CellCoord cellCoord = i_cell.GetCellCoord();
     if (CellObjectGuids const* cell_guids = sObjectMgr->GetCellObjectGuids(i_map->GetId(), i_map->GetSpawnMode(), cellCoord.GetId()))
-        LoadHelper(cell_guids->creatures, cellCoord, m, i_creatures, i_map);
+        LoadHelper(cell_guids->creatures, cellCoord, m, i_grid.GetCellIndex(i_cell.CellX(), i_cell.CellY()), i_creatures, i_map);
 }
 
 void ObjectWorldLoader::Visit(CorpseMapType& /*m*/)
@@ -147,6 +148,7 @@ void ObjectWorldLoader::Visit(CorpseMapType& /*m*/)
             else
                 cell.AddGridObject(corpse);
 
+            i_grid.GetCellIndex(i_cell.CellX(), i_cell.CellY()).Insert(corpse);
             ++i_corpses;
         }
     }
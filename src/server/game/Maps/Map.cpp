@@ -34,6 +34,7 @@
 #include "InstanceSaveMgr.h"
 #include "Log.h"
 #include "MapManager.h"
+#include "Metric.h"
 #include "MiscPackets.h"
 #include "MotionMaster.h"
 #include "ObjectAccessor.h"
@@ -44,6 +45,7 @@
 #include "PoolMgr.h"
 #include "PhasingHandler.h"
 #include "ScriptMgr.h"
+#include "StringFormat.h"
 #include "TerrainMgr.h"
 #include "Transport.h"
 #include "Vehicle.h"
@@ -51,10 +53,14 @@
 #include "VMapManager2.h"
 #include "Weather.h"
 #include "WeatherMgr.h"
+#include "WorkStealingExecutor.h"
 #include "World.h"
 #include "WorldStateMgr.h"
 #include "WorldStatePackets.h"
 #include <boost/heap/fibonacci_heap.hpp>
+#include <array>
+#include <latch>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
@@ -122,6 +128,7 @@ void Map::InitStateMachine()
     si_GridStates[GRID_STATE_ACTIVE] = new ActiveState();
     si_GridStates[GRID_STATE_IDLE] = new IdleState();
     si_GridStates[GRID_STATE_REMOVAL] = new RemovalState();
+    si_GridStates[GRID_STATE_RETAINED] = new RetainedState();
 }
 
 void Map::DeleteStateMachine()
@@ -130,6 +137,7 @@ void Map::DeleteStateMachine()
     delete si_GridStates[GRID_STATE_ACTIVE];
     delete si_GridStates[GRID_STATE_IDLE];
     delete si_GridStates[GRID_STATE_REMOVAL];
+    delete si_GridStates[GRID_STATE_RETAINED];
 }
 
 Map::Map(uint32 id, time_t expiry, uint32 InstanceId, uint8 SpawnMode) :
@@ -139,7 +147,11 @@ m_unloadTimer(0), m_VisibleDistance(DEFAULT_VISIBILITY_DISTANCE),
 m_VisibilityNotifyPeriod(DEFAULT_VISIBILITY_NOTIFY_PERIOD),
 m_activeNonPlayersIter(m_activeNonPlayers.end()), _transportsUpdateIter(_transports.end()),
 i_gridExpiry(expiry), m_terrain(sTerrainMgr.LoadTerrain(id)),  m_forceEnabledNavMeshFilterFlags(0), m_forceDisabledNavMeshFilterFlags(0),
-i_scriptLock(false), _respawnTimes(std::make_unique<RespawnListContainer>()), _respawnCheckTimer(0)
+_farUnitCellsBegin(0), _farUnitCellsEnd(0), i_scriptLock(false), _regionUpdateActive(false), _respawnTimes(std::make_unique<RespawnListContainer>()), _respawnCheckTimer(0),
+_lastUpdateCost(0), _averageUpdateCost(0),
+_degradationLevel(MAP_DEGRADATION_NONE), _degradationCooldown(0), _updateTick(0), _staggerWaitedDiff(0),
+_hibernating(false), _wakeUpRequested(false), _hibernationGeneration(0), _hibernationStartTime(0),
+_retainedGridsMemory(0), _gridLoadCount(0), _gridUnloadCount(0), _gridRetainCount(0), _gridReuseCount(0)
 {
     for (uint32 x = 0; x < MAX_NUMBER_OF_GRIDS; ++x)
     {
@@ -156,6 +168,7 @@ i_scriptLock(false), _respawnTimes(std::make_unique<RespawnListContainer>()), _r
     Map::InitVisibilityDistance();
 
     _weatherUpdateTimer.SetInterval(time_t(1 * IN_MILLISECONDS));
+    _gridMetricsTimer.SetInterval(time_t(MINUTE * IN_MILLISECONDS));
 
     _poolData = sPoolMgr->InitPoolsForMap(this);
 
@@ -187,6 +200,8 @@ void Map::AddToGrid(T* obj, Cell const& cell)
         grid->GetGridType(cell.CellX(), cell.CellY()).template AddWorldObject<T>(obj);
     else
         grid->GetGridType(cell.CellX(), cell.CellY()).template AddGridObject<T>(obj);
+
+    grid->GetCellIndex(cell.CellX(), cell.CellY()).Insert(obj);
 }
 
 template<>
@@ -198,6 +213,7 @@ void Map::AddToGrid(Creature* obj, Cell const& cell)
     else
         grid->GetGridType(cell.CellX(), cell.CellY()).AddGridObject(obj);
 
+    grid->GetCellIndex(cell.CellX(), cell.CellY()).Insert(obj);
     obj->SetCurrentCell(cell);
 }
 
@@ -206,6 +222,7 @@ void Map::AddToGrid(GameObject* obj, Cell const& cell)
 {
     NGridType* grid = getNGrid(cell.GridX(), cell.GridY());
     grid->GetGridType(cell.CellX(), cell.CellY()).AddGridObject(obj);
+    grid->GetCellIndex(cell.CellX(), cell.CellY()).Insert(obj);
 
     obj->SetCurrentCell(cell);
 }
@@ -219,6 +236,7 @@ void Map::AddToGrid(DynamicObject* obj, Cell const& cell)
     else
         grid->GetGridType(cell.CellX(), cell.CellY()).AddGridObject(obj);
 
+    grid->GetCellIndex(cell.CellX(), cell.CellY()).Insert(obj);
     obj->SetCurrentCell(cell);
 }
 
@@ -238,6 +256,8 @@ void Map::AddToGrid(Corpse* obj, Cell const& cell)
             grid->GetGridType(cell.CellX(), cell.CellY()).AddWorldObject(obj);
         else
             grid->GetGridType(cell.CellX(), cell.CellY()).AddGridObject(obj);
+
+        grid->GetCellIndex(cell.CellX(), cell.CellY()).Insert(obj);
     }
 }
 
@@ -287,6 +307,7 @@ void Map::SwitchGridContainers(Creature* obj, bool on)
     }
 
     obj->m_isTempWorldObject = on;
+    CellSpatialIndex::Update(obj);
 }
 
 template<>
@@ -330,6 +351,8 @@ void Map::SwitchGridContainers(GameObject* obj, bool on)
         grid.AddGridObject(obj);
         RemoveWorldObject(obj);
     }
+
+    CellSpatialIndex::Update(obj);
 }
 
 template<class T>
@@ -357,6 +380,7 @@ void Map::EnsureGridCreated(GridCoord const& p)
 
         NGridType* ngrid = new NGridType(p.x_coord * MAX_NUMBER_OF_GRIDS + p.y_coord, p.x_coord, p.y_coord, i_gridExpiry, sWorld->getBoolConfig(CONFIG_GRID_UNLOAD));
         setNGrid(ngrid, p.x_coord, p.y_coord);
+        ngrid->AttachCellOccupancy(&_cellOccupancy);
 
         // build a linkage between this map and NGridType
         buildNGridLinkage(ngrid);
@@ -381,6 +405,13 @@ void Map::EnsureGridLoadedForActiveObject(const Cell &cell, WorldObject* object)
     // refresh grid state & timer
     if (grid->GetGridState() != GRID_STATE_ACTIVE)
     {
+        // objects of a retained grid are still there, nothing to reload
+        if (grid->GetGridState() == GRID_STATE_RETAINED)
+        {
+            ForgetRetainedGrid(*grid);
+            ++_gridReuseCount;
+        }
+
         TC_LOG_DEBUG("maps", "Active object %s triggers loading of grid [%u, %u] on map %u", object->GetGUID().ToString().c_str(), cell.GridX(), cell.GridY(), GetId());
         ResetGridExpiry(*grid, 0.1f);
         grid->SetGridState(GRID_STATE_ACTIVE);
@@ -399,6 +430,7 @@ bool Map::EnsureGridLoaded(const Cell &cell)
         TC_LOG_DEBUG("maps", "Loading grid[%u, %u] for map %u instance %u", cell.GridX(), cell.GridY(), GetId(), i_InstanceId);
 
         setGridObjectDataLoaded(true, cell.GridX(), cell.GridY());
+        ++_gridLoadCount;
 
         ObjectGridLoader loader(*grid, this, cell);
         loader.LoadN();
@@ -410,6 +442,98 @@ bool Map::EnsureGridLoaded(const Cell &cell)
     return false;
 }
 
+struct Map::GridPreload
+{
+    std::atomic<bool> Ready = false;                        // set by the executor job once Files is filled
+    uint32 StartTime = 0;
+    TerrainGridPreload Files;
+};
+
+void Map::PreloadGridAhead(Unit const* unit)
+{
+    uint32 lookAhead = sWorld->getIntConfig(CONFIG_MAP_GRID_PRELOAD_LOOKAHEAD);
+    if (!lookAhead || !unit->isMoving() || !sMapMgr->GetMapUpdater()->activated())
+        return;
+
+    float distance = unit->GetSpeed(unit->IsFlying() ? MOVE_FLIGHT : MOVE_RUN) * lookAhead / float(IN_MILLISECONDS);
+    float x = unit->GetPositionX() + distance * std::cos(unit->GetOrientation());
+    float y = unit->GetPositionY() + distance * std::sin(unit->GetOrientation());
+    if (!Trinity::IsValidMapCoord(x, y))
+        return;
+
+    GridCoord p = Trinity::ComputeGridCoord(x, y);
+    if (isGridObjectDataLoaded(p.x_coord, p.y_coord))
+        return;
+
+    auto itr = _gridPreloads.try_emplace(p.GetId(), nullptr).first;
+    if (itr->second)
+        return;
+
+    // only the map files are read off the map thread, they are not seen by terrain queries until the grid is linked
+    int32 gx = (MAX_NUMBER_OF_GRIDS - 1) - p.x_coord;
+    int32 gy = (MAX_NUMBER_OF_GRIDS - 1) - p.y_coord;
+    itr->second = std::make_shared<GridPreload>();
+    itr->second->StartTime = GameTime::GetGameTimeMS();
+    sMapMgr->GetMapUpdater()->GetExecutor()->Post([terrain = m_terrain, preload = itr->second, gx, gy]()
+    {
+        preload->Files = terrain->ReadGridMaps(gx, gy);
+        preload->Ready.store(true, std::memory_order_release);
+    }, Trinity::TaskPriority::Low);
+}
+
+bool Map::IsGridNearPlayers(GridCoord const& p) const
+{
+    // one cell beyond the sight range, the grid is linked just before visibility would load it
+    uint32 lowX = p.x_coord * MAX_NUMBER_OF_CELLS;
+    uint32 lowY = p.y_coord * MAX_NUMBER_OF_CELLS;
+    for (MapReference const& ref : m_mapRefManager)
+    {
+        Player const* player = ref.GetSource();
+        CellArea area = Cell::CalculateCellArea(player->GetPositionX(), player->GetPositionY(), GetVisibilityRange() + SIZE_OF_GRID_CELL);
+        if (area.high_bound.x_coord >= lowX && area.low_bound.x_coord < lowX + MAX_NUMBER_OF_CELLS
+            && area.high_bound.y_coord >= lowY && area.low_bound.y_coord < lowY + MAX_NUMBER_OF_CELLS)
+            return true;
+    }
+
+    return false;
+}
+
+void Map::LinkPreloadedGrids()
+{
+    // a projected heading is only a guess, grids are linked once a player actually gets close and
+    // dropped unlinked when nobody did, so a wrong guess never creates objects on the map thread
+    uint32 const expiry = 2 * sWorld->getIntConfig(CONFIG_MAP_GRID_PRELOAD_LOOKAHEAD);
+    bool gridLoaded = false;
+    for (auto itr = _gridPreloads.begin(); itr != _gridPreloads.end();)
+    {
+        if (!itr->second->Ready.load(std::memory_order_acquire))
+        {
+            ++itr;
+            continue;
+        }
+
+        GridCoord p(itr->first % MAX_NUMBER_OF_GRIDS, itr->first / MAX_NUMBER_OF_GRIDS);
+        if (!isGridObjectDataLoaded(p.x_coord, p.y_coord))
+        {
+            if (gridLoaded || !IsGridNearPlayers(p))
+            {
+                if (getMSTimeDiff(itr->second->StartTime, GameTime::GetGameTimeMS()) > expiry)
+                    itr = _gridPreloads.erase(itr);
+                else
+                    ++itr;
+                continue;
+            }
+
+            // vmap and mmap tiles are loaded here with the grid, on the map thread that queries them
+            TC_LOG_DEBUG("maps", "Linking preloaded grid[%u, %u] for map %u instance %u", p.x_coord, p.y_coord, GetId(), i_InstanceId);
+            m_terrain->AddPreloadedGridMaps((MAX_NUMBER_OF_GRIDS - 1) - p.x_coord, (MAX_NUMBER_OF_GRIDS - 1) - p.y_coord, std::move(itr->second->Files));
+            gridLoaded = EnsureGridLoaded(Cell(CellCoord(p.x_coord * MAX_NUMBER_OF_CELLS, p.y_coord * MAX_NUMBER_OF_CELLS)));
+        }
+
+        itr = _gridPreloads.erase(itr);
+    }
+}
+
 void Map::GridMarkNoUnload(uint32 x, uint32 y)
 {
     // First make sure this grid is loaded
@@ -440,6 +564,8 @@ void Map::LoadGrid(float x, float y)
 
 bool Map::AddPlayerToMap(Player* player)
 {
+    RequestWakeUp();
+
     CellCoord cellCoord = Trinity::ComputeCellCoord(player->GetPositionX(), player->GetPositionY());
     if (!cellCoord.IsCoordValid())
     {
@@ -488,6 +614,8 @@ void Map::InitializeObject(GameObject* obj)
 template<class T>
 bool Map::AddToMap(T* obj)
 {
+    RegionGuard guard(this);
+
     /// @todo Needs clean up. An object should not be added to map twice.
     if (obj->IsInWorld())
     {
@@ -535,6 +663,9 @@ bool Map::AddToMap(T* obj)
 template<>
 bool Map::AddToMap(Transport* obj)
 {
+    RegionGuard guard(this);
+    RequestWakeUp();
+
     //TODO: Needs clean up. An object should not be added to map twice.
     if (obj->IsInWorld())
         return true;
@@ -575,7 +706,7 @@ bool Map::IsGridLoaded(const GridCoord &p) const
     return (getNGrid(p.x_coord, p.y_coord) && isGridObjectDataLoaded(p.x_coord, p.y_coord));
 }
 
-void Map::VisitNearbyCellsOf(WorldObject* obj, TypeContainerVisitor<Trinity::ObjectUpdater, GridTypeMapContainer> &gridVisitor, TypeContainerVisitor<Trinity::ObjectUpdater, WorldTypeMapContainer> &worldVisitor)
+void Map::MarkNearbyCellsOf(WorldObject* obj)
 {
     // Check for valid position
     if (!obj->IsPositionValid())
@@ -588,20 +719,249 @@ void Map::VisitNearbyCellsOf(WorldObject* obj, TypeContainerVisitor<Trinity::Obj
     {
         for (uint32 y = area.low_bound.y_coord; y <= area.high_bound.y_coord; ++y)
         {
-            // marked cells are those that have been visited
+            // marked cells are those that will be updated this tick
             // don't visit the same cell twice
             uint32 cell_id = (y * TOTAL_NUMBER_OF_CELLS_PER_MAP) + x;
             if (isCellMarked(cell_id))
                 continue;
 
             markCell(cell_id);
-            CellCoord pair(x, y);
-            Cell cell(pair);
-            cell.SetNoCreate();
-            Visit(cell, gridVisitor);
-            Visit(cell, worldVisitor);
+            _markedCellIds.push_back(cell_id);
+        }
+    }
+}
+
+void Map::MarkCellsNearPlayer(WorldObject* obj)
+{
+    if (!obj->IsPositionValid())
+        return;
+
+    CellArea area = Cell::CalculateCellArea(obj->GetPositionX(), obj->GetPositionY(), sWorld->getFloatConfig(CONFIG_MAP_UPDATE_FAR_CREATURES_NEAR_RANGE));
+    for (uint32 x = area.low_bound.x_coord; x <= area.high_bound.x_coord; ++x)
+        for (uint32 y = area.low_bound.y_coord; y <= area.high_bound.y_coord; ++y)
+            _nearPlayerCells.set((y * TOTAL_NUMBER_OF_CELLS_PER_MAP) + x);
+}
+
+static void UpdateCells(Map& map, std::vector<uint32> const& cellIds, uint32 diff)
+{
+    uint32 buckets = std::max(sWorld->getIntConfig(CONFIG_MAP_UPDATE_CREATURE_BUCKETS), 1u);
+    uint32 farInterval = std::max(sWorld->getIntConfig(CONFIG_MAP_UPDATE_FAR_CREATURES_INTERVAL), 1u);
+    Trinity::ObjectUpdater updater(diff, buckets, farInterval);
+    // for creature
+    TypeContainerVisitor<Trinity::ObjectUpdater, GridTypeMapContainer  > grid_object_update(updater);
+    // for pets
+    TypeContainerVisitor<Trinity::ObjectUpdater, WorldTypeMapContainer > world_object_update(updater);
+
+    for (uint32 cellId : cellIds)
+    {
+        Cell cell(CellCoord(cellId % TOTAL_NUMBER_OF_CELLS_PER_MAP, cellId / TOTAL_NUMBER_OF_CELLS_PER_MAP));
+        cell.SetNoCreate();
+        updater.i_far = farInterval > 1 && !map.IsCellNearPlayer(cellId);
+        map.Visit(cell, grid_object_update);
+        map.Visit(cell, world_object_update);
+    }
+}
+
+void Map::UpdateMarkedCells(uint32 diff)
+{
+    if (_degradationLevel < MAP_DEGRADATION_STAGGER && _staggerWaitingCellIds.empty())
+    {
+        UpdateCellIds(_markedCellIds, diff);
+        return;
+    }
+
+    // half of the cells every tick. Cells only marked for far combat partners are never skipped, their
+    // creatures are fighting players, and a cell skipped in the previous tick catches up on its time
+    uint32 parity = _updateTick & 1;
+    bool stagger = _degradationLevel >= MAP_DEGRADATION_STAGGER;
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < _markedCellIds.size(); ++i)
+    {
+        uint32 cellId = _markedCellIds[i];
+        bool farUnitCell = i >= _farUnitCellsBegin && i < _farUnitCellsEnd;
+        if (stagger && !farUnitCell && ((cellId % TOTAL_NUMBER_OF_CELLS_PER_MAP + cellId / TOTAL_NUMBER_OF_CELLS_PER_MAP) & 1) != parity)
+            _staggerNextWaitingCellIds.push_back(cellId);
+        else if (_staggerWaitingCells.test(cellId))
+            _staggerCatchUpCellIds.push_back(cellId);
+        else
+            _markedCellIds[kept++] = cellId;
+    }
+    _markedCellIds.resize(kept);
+
+    for (uint32 cellId : _staggerWaitingCellIds)
+        _staggerWaitingCells.reset(cellId);
+    for (uint32 cellId : _staggerNextWaitingCellIds)
+        _staggerWaitingCells.set(cellId);
+    _staggerWaitingCellIds.swap(_staggerNextWaitingCellIds);
+    _staggerNextWaitingCellIds.clear();
+
+    UpdateCellIds(_markedCellIds, diff);
+    UpdateCellIds(_staggerCatchUpCellIds, diff + _staggerWaitedDiff);
+    _staggerCatchUpCellIds.clear();
+    _staggerWaitedDiff = diff;
+}
+
+void Map::UpdateCellIds(std::vector<uint32> const& cellIds, uint32 diff)
+{
+    if (cellIds.empty())
+        return;
+
+    if (CanUpdateInRegions())
+        UpdateCellIdsInRegions(cellIds, diff);
+    else
+        UpdateCells(*this, cellIds, diff);
+}
+
+struct MapRegionUpdateContext
+{
+    // dynamic tree changes requested by the region, replayed in order by the map thread
+    std::vector<std::pair<GameObjectModel const*, bool>> GameObjectModelChanges;
+};
+
+namespace
+{
+    thread_local MapRegionUpdateContext* CurrentRegionUpdateContext = nullptr;
+
+    struct MapRegion
+    {
+        std::vector<uint32> CellIds;
+        MapRegionUpdateContext Context;
+    };
+}
+
+bool Map::CanUpdateInRegions() const
+{
+    if (Instanceable() || !sWorld->getBoolConfig(CONFIG_MAP_UPDATE_REGIONS) || !sMapMgr->GetMapUpdater()->activated())
+        return false;
+
+    return m_mapRefManager.getSize() >= sWorld->getIntConfig(CONFIG_MAP_UPDATE_REGION_MIN_PLAYERS);
+}
+
+void Map::UpdateCellIdsInRegions(std::vector<uint32> const& cellIds, uint32 diff)
+{
+    // every grid holding marked cells is a region. Searchers reach up to one grid around the region's own,
+    // so grids of the same color are three grids apart and no grid is reached by two regions of a pass
+    std::array<std::unordered_map<uint32, MapRegion>, 9> colors;
+    for (uint32 cellId : cellIds)
+    {
+        uint32 gridX = (cellId % TOTAL_NUMBER_OF_CELLS_PER_MAP) / MAX_NUMBER_OF_CELLS;
+        uint32 gridY = (cellId / TOTAL_NUMBER_OF_CELLS_PER_MAP) / MAX_NUMBER_OF_CELLS;
+        colors[(gridX % 3) + (gridY % 3) * 3][gridY * MAX_NUMBER_OF_GRIDS + gridX].CellIds.push_back(cellId);
+    }
+
+    for (std::unordered_map<uint32, MapRegion>& color : colors)
+    {
+        if (color.empty())
+            continue;
+
+        std::vector<MapRegion*> regions;
+        regions.reserve(color.size());
+        for (std::pair<uint32 const, MapRegion>& region : color)
+            regions.push_back(&region.second);
+
+        RunRegionsInParallel(regions.size(), [this, diff, &regions](std::size_t index)
+        {
+            CurrentRegionUpdateContext = &regions[index]->Context;
+            UpdateCells(*this, regions[index]->CellIds, diff);
+            CurrentRegionUpdateContext = nullptr;
+        });
+
+        for (MapRegion* region : regions)
+            MergeRegionUpdateContext(region->Context);
+    }
+}
+
+void Map::RunRegionsInParallel(std::size_t count, std::function<void(std::size_t)> const& work)
+{
+    if (!count)
+        return;
+
+    // line of sight and height queries lazily rebalance the tree, do it upfront to keep them read only
+    _dynamicTree.balance();
+
+    _regionUpdateActive = true;
+
+    // the map thread takes the first region itself, then helps with other region jobs
+    // instead of blocking since it is itself one of the executor workers
+    Trinity::WorkStealingExecutor* executor = sMapMgr->GetMapUpdater()->GetExecutor();
+    std::latch done(count - 1);
+    for (std::size_t i = 1; i < count; ++i)
+    {
+        executor->Post([&work, &done, i]()
+        {
+            work(i);
+            done.count_down();
+        }, Trinity::TaskPriority::High);
+    }
+
+    work(0);
+    executor->HelpUntil([&done]() { return done.try_wait(); }, Trinity::TaskPriority::High);
+
+    _regionUpdateActive = false;
+}
+
+void Map::MergeRegionUpdateContext(MapRegionUpdateContext& context)
+{
+    auto& changes = context.GameObjectModelChanges;
+    for (auto itr = changes.begin(); itr != changes.end(); ++itr)
+    {
+        if (itr->second)
+        {
+            // a model removed again later in the same pass may already be deleted (GameObject::UpdateModel)
+            if (std::any_of(itr + 1, changes.end(), [model = itr->first](std::pair<GameObjectModel const*, bool> const& change) { return change.first == model; }))
+                continue;
+
+            _dynamicTree.insert(*itr->first);
         }
+        else if (_dynamicTree.contains(*itr->first))
+            _dynamicTree.remove(*itr->first);
+    }
+
+    changes.clear();
+}
+
+void Map::Balance()
+{
+    // rebalanced by the map thread before every region pass
+    if (_regionUpdateActive)
+        return;
+
+    _dynamicTree.balance();
+}
+
+void Map::RemoveGameObjectModel(GameObjectModel const& model)
+{
+    if (_regionUpdateActive && CurrentRegionUpdateContext)
+    {
+        CurrentRegionUpdateContext->GameObjectModelChanges.emplace_back(&model, false);
+        return;
+    }
+
+    _dynamicTree.remove(model);
+}
+
+void Map::InsertGameObjectModel(GameObjectModel const& model)
+{
+    if (_regionUpdateActive && CurrentRegionUpdateContext)
+    {
+        CurrentRegionUpdateContext->GameObjectModelChanges.emplace_back(&model, true);
+        return;
     }
+
+    _dynamicTree.insert(model);
+}
+
+bool Map::ContainsGameObjectModel(GameObjectModel const& model) const
+{
+    if (_regionUpdateActive && CurrentRegionUpdateContext)
+    {
+        auto const& changes = CurrentRegionUpdateContext->GameObjectModelChanges;
+        auto itr = std::find_if(changes.rbegin(), changes.rend(), [&model](std::pair<GameObjectModel const*, bool> const& change) { return change.first == &model; });
+        if (itr != changes.rend())
+            return itr->second;
+    }
+
+    return _dynamicTree.contains(model);
 }
 
 void Map::UpdatePlayerZoneStats(uint32 oldZone, uint32 newZone)
@@ -621,6 +981,10 @@ void Map::UpdatePlayerZoneStats(uint32 oldZone, uint32 newZone)
 
 void Map::Update(uint32 t_diff)
 {
+    // anything requested from now on keeps the map awake for the next tick
+    _wakeUpRequested = false;
+    ++_updateTick;
+
     _dynamicTree.update(t_diff);
     /// update worldsessions for existing players
     for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
@@ -645,14 +1009,17 @@ void Map::Update(uint32 t_diff)
     else
         _respawnCheckTimer -= t_diff;
 
+    LinkPreloadedGrids();
+
     /// update active cells around players and active objects
     resetMarkedCells();
 
-    Trinity::ObjectUpdater updater(t_diff);
-    // for creature
-    TypeContainerVisitor<Trinity::ObjectUpdater, GridTypeMapContainer  > grid_object_update(updater);
-    // for pets
-    TypeContainerVisitor<Trinity::ObjectUpdater, WorldTypeMapContainer > world_object_update(updater);
+    bool const farCreatureUpdates = sWorld->getIntConfig(CONFIG_MAP_UPDATE_FAR_CREATURES_INTERVAL) > 1;
+    if (farCreatureUpdates)
+        _nearPlayerCells.reset();
+
+    // far aura casters are not critical, a degraded map visits them less often
+    bool const visitFarAuraCasters = _degradationLevel < MAP_DEGRADATION_RELOCATION || !(_updateTick % 4);
 
     // the player iterator is stored in the map object
     // to make sure calls to Map::Remove don't invalidate it
@@ -666,47 +1033,53 @@ void Map::Update(uint32 t_diff)
         // update players at tick
         player->Update(t_diff);
 
-        VisitNearbyCellsOf(player, grid_object_update, world_object_update);
+        MarkNearbyCellsOf(player);
+        if (farCreatureUpdates)
+            MarkCellsNearPlayer(player);
+
+        PreloadGridAhead(player);
 
         // If player is using far sight or mind vision, visit that object too
         if (WorldObject* viewPoint = player->GetViewpoint())
-            VisitNearbyCellsOf(viewPoint, grid_object_update, world_object_update);
+        {
+            MarkNearbyCellsOf(viewPoint);
+            if (farCreatureUpdates)
+                MarkCellsNearPlayer(viewPoint);
+        }
 
         // Handle updates for creatures in combat with player and are more than 60 yards away
         if (player->IsInCombat())
         {
-            std::vector<Unit*> toVisit;
             for (auto const& pair : player->GetCombatManager().GetPvECombatRefs())
                 if (Creature* unit = pair.second->GetOther(player)->ToCreature())
                     if (unit->GetMapId() == player->GetMapId() && !unit->IsWithinDistInMap(player, GetVisibilityRange(), false))
-                        toVisit.push_back(unit);
-            for (Unit* unit : toVisit)
-                VisitNearbyCellsOf(unit, grid_object_update, world_object_update);
+                        if (unit->QueueForFarCellMarking(_updateTick))
+                            _farUnitsToMark.push_back(unit);
         }
 
-        { // Update any creatures that own auras the player has applications of
-            std::unordered_set<Unit*> toVisit;
-            for (std::pair<uint32, AuraApplication*> pair : player->GetAppliedAuras())
+        // Update any creatures that own auras the player has applications of
+        if (visitFarAuraCasters)
+        {
+            for (std::pair<uint32 const, AuraApplication*> const& pair : player->GetAppliedAuras())
             {
                 if (Unit* caster = pair.second->GetBase()->GetCaster())
                     if (caster->GetTypeId() != TYPEID_PLAYER && !caster->IsWithinDistInMap(player, GetVisibilityRange(), false))
-                        toVisit.insert(caster);
+                        if (caster->QueueForFarCellMarking(_updateTick))
+                            _farUnitsToMark.push_back(caster);
             }
-            for (Unit* unit : toVisit)
-                VisitNearbyCellsOf(unit, grid_object_update, world_object_update);
         }
+    }
 
-        { // Update any creatures that own auras the player has applications of
-            std::unordered_set<Unit*> toVisit;
-            for (std::pair<uint32, AuraApplication*> pair : player->GetAppliedAuras())
-            {
-                if (Unit* caster = pair.second->GetBase()->GetCaster())
-                    if (caster->GetTypeId() != TYPEID_PLAYER && !caster->IsWithinDistInMap(player, GetVisibilityRange(), false))
-                        toVisit.insert(caster);
-            }
-            for (Unit* unit : toVisit)
-                VisitNearbyCellsOf(unit, grid_object_update, world_object_update);
-        }
+    // far units are collected for all players first, a raid fighting the same far away boss marks its cells once
+    _farUnitCellsBegin = _farUnitCellsEnd = _markedCellIds.size();
+    if (!_farUnitsToMark.empty())
+    {
+        for (Unit* unit : _farUnitsToMark)
+            MarkNearbyCellsOf(unit);
+        _farUnitCellsEnd = _markedCellIds.size();
+
+        // keeps its capacity, no allocations once the map reached its usual size
+        _farUnitsToMark.clear();
     }
 
     // non-player active objects, increasing iterator in the loop in case of object removal
@@ -718,9 +1091,11 @@ void Map::Update(uint32 t_diff)
         if (!obj || !obj->IsInWorld())
             continue;
 
-        VisitNearbyCellsOf(obj, grid_object_update, world_object_update);
+        MarkNearbyCellsOf(obj);
     }
 
+    UpdateMarkedCells(t_diff);
+
     for (_transportsUpdateIter = _transports.begin(); _transportsUpdateIter != _transports.end();)
     {
         WorldObject* obj = *_transportsUpdateIter;
@@ -732,7 +1107,7 @@ void Map::Update(uint32 t_diff)
     SendObjectUpdates();
 
     ///- Process necessary scripts
-    if (!m_scriptSchedule.empty())
+    if (!m_scriptSchedule.empty() && (_degradationLevel < MAP_DEGRADATION_SCRIPTS || !(_updateTick % 4)))
     {
         i_scriptLock = true;
         ScriptsProcess();
@@ -753,7 +1128,7 @@ void Map::Update(uint32 t_diff)
     MoveAllGameObjectsInMoveList();
 
     if (!m_mapRefManager.isEmpty() || !m_activeNonPlayers.empty())
-        ProcessRelocationNotifies(t_diff);
+        ProcessRelocationNotifies(_degradationLevel >= MAP_DEGRADATION_RELOCATION ? t_diff / 2 : t_diff);
 
     sScriptMgr->OnMapUpdate(this, t_diff);
 }
@@ -772,6 +1147,11 @@ struct ResetNotifier
 
 void Map::ProcessRelocationNotifies(uint32 diff)
 {
+    bool const inRegions = CanUpdateInRegions() && sWorld->getBoolConfig(CONFIG_MAP_UPDATE_REGIONS_RELOCATION);
+
+    // grid id -> marked cells, only used for region notifies
+    std::unordered_map<uint32, std::vector<uint32>> relocationGrids;
+
     for (GridRefManager<NGridType>::iterator i = GridRefManager<NGridType>::begin(); i != GridRefManager<NGridType>::end(); ++i)
     {
         NGridType *grid = i->GetSource();
@@ -796,19 +1176,17 @@ void Map::ProcessRelocationNotifies(uint32 diff)
                 if (!isCellMarked(cell_id))
                     continue;
 
-                CellCoord pair(x, y);
-                Cell cell(pair);
-                cell.SetNoCreate();
-
-                Trinity::DelayedUnitRelocation cell_relocation(cell, pair, *this, MAX_VISIBILITY_DISTANCE);
-                TypeContainerVisitor<Trinity::DelayedUnitRelocation, GridTypeMapContainer  > grid_object_relocation(cell_relocation);
-                TypeContainerVisitor<Trinity::DelayedUnitRelocation, WorldTypeMapContainer > world_object_relocation(cell_relocation);
-                Visit(cell, grid_object_relocation);
-                Visit(cell, world_object_relocation);
+                if (inRegions)
+                    relocationGrids[gy * MAX_NUMBER_OF_GRIDS + gx].push_back(cell_id);
+                else
+                    NotifyRelocationsInCell(cell_id, nullptr);
             }
         }
     }
 
+    if (!relocationGrids.empty())
+        NotifyRelocationsInRegions(relocationGrids);
+
     ResetNotifier reset;
     TypeContainerVisitor<ResetNotifier, GridTypeMapContainer >  grid_notifier(reset);
     TypeContainerVisitor<ResetNotifier, WorldTypeMapContainer > world_notifier(reset);
@@ -847,6 +1225,54 @@ void Map::ProcessRelocationNotifies(uint32 diff)
     }
 }
 
+void Map::NotifyRelocationsInCell(uint32 cellId, Trinity::DeferredRelocationWork* deferred)
+{
+    CellCoord pair(cellId % TOTAL_NUMBER_OF_CELLS_PER_MAP, cellId / TOTAL_NUMBER_OF_CELLS_PER_MAP);
+    Cell cell(pair);
+    cell.SetNoCreate();
+
+    Trinity::DelayedUnitRelocation cell_relocation(cell, pair, *this, MAX_VISIBILITY_DISTANCE, deferred);
+    TypeContainerVisitor<Trinity::DelayedUnitRelocation, GridTypeMapContainer  > grid_object_relocation(cell_relocation);
+    TypeContainerVisitor<Trinity::DelayedUnitRelocation, WorldTypeMapContainer > world_object_relocation(cell_relocation);
+    Visit(cell, grid_object_relocation);
+    Visit(cell, world_object_relocation);
+}
+
+void Map::NotifyRelocationsInRegions(std::unordered_map<uint32, std::vector<uint32>> const& relocationGrids)
+{
+    // a notify reads up to one grid around its own, so grids notified together are three grids apart.
+    // Players only update their own view in parallel, whatever changes other objects is queued for the map thread
+    std::array<std::vector<std::vector<uint32> const*>, 9> colors;
+    for (std::pair<uint32 const, std::vector<uint32>> const& grid : relocationGrids)
+    {
+        uint32 gridX = grid.first % MAX_NUMBER_OF_GRIDS;
+        uint32 gridY = grid.first / MAX_NUMBER_OF_GRIDS;
+        colors[(gridX % 3) + (gridY % 3) * 3].push_back(&grid.second);
+    }
+
+    for (std::vector<std::vector<uint32> const*>& color : colors)
+    {
+        if (color.empty())
+            continue;
+
+        std::vector<MapRegion> regions(color.size());
+        std::vector<Trinity::DeferredRelocationWork> deferred(color.size());
+        RunRegionsInParallel(color.size(), [this, &color, &regions, &deferred](std::size_t index)
+        {
+            CurrentRegionUpdateContext = &regions[index].Context;
+            for (uint32 cellId : *color[index])
+                NotifyRelocationsInCell(cellId, &deferred[index]);
+            CurrentRegionUpdateContext = nullptr;
+        });
+
+        for (std::size_t i = 0; i < color.size(); ++i)
+        {
+            MergeRegionUpdateContext(regions[i].Context);
+            deferred[i].Run(MAX_VISIBILITY_DISTANCE);
+        }
+    }
+}
+
 void Map::RemovePlayerFromMap(Player* player, bool remove)
 {
     // Before leaving map, update zone/area for stats
@@ -867,6 +1293,8 @@ void Map::RemovePlayerFromMap(Player* player, bool remove)
     else
         ASSERT(remove); //maybe deleted in logoutplayer when player is not in a map
 
+    CellSpatialIndex::Remove(player);
+
     if (remove)
         DeleteFromWorld(player);
 }
@@ -874,6 +1302,8 @@ void Map::RemovePlayerFromMap(Player* player, bool remove)
 template<class T>
 void Map::RemoveFromMap(T *obj, bool remove)
 {
+    RegionGuard guard(this);
+
     bool const inWorld = obj->IsInWorld() && obj->GetTypeId() >= TYPEID_UNIT && obj->GetTypeId() <= TYPEID_GAMEOBJECT;
     obj->RemoveFromWorld();
 
@@ -884,6 +1314,7 @@ void Map::RemoveFromMap(T *obj, bool remove)
         obj->UpdateObjectVisibilityOnDestroy();
 
     obj->RemoveFromGrid();
+    CellSpatialIndex::Remove(obj);
 
     obj->ResetMap();
 
@@ -894,6 +1325,8 @@ void Map::RemoveFromMap(T *obj, bool remove)
 template<>
 void Map::RemoveFromMap(Transport* obj, bool remove)
 {
+    RegionGuard guard(this);
+
     if (obj->IsInWorld())
     {
         obj->RemoveFromWorld();
@@ -974,7 +1407,7 @@ void Map::PlayerRelocation(Player* player, float x, float y, float z, float orie
     }
 
     player->UpdatePositionData();
-    player->UpdateObjectVisibility(false);
+    player->UpdateObjectVisibilityOnRelocation();
 }
 
 void Map::CreatureRelocation(Creature* creature, float x, float y, float z, float ang, bool respawnRelocationOnFail)
@@ -1069,6 +1502,7 @@ void Map::AddCreatureToMoveList(Creature* c, float x, float y, float z, float an
     if (_creatureToMoveLock) //can this happen?
         return;
 
+    RegionGuard guard(this);
     if (c->_moveState == MAP_OBJECT_CELL_MOVE_NONE)
         _creaturesToMove.push_back(c);
     c->SetNewCellPosition(x, y, z, ang);
@@ -1088,6 +1522,7 @@ void Map::AddGameObjectToMoveList(GameObject* go, float x, float y, float z, flo
     if (_gameObjectsToMoveLock) //can this happen?
         return;
 
+    RegionGuard guard(this);
     if (go->_moveState == MAP_OBJECT_CELL_MOVE_NONE)
         _gameObjectsToMove.push_back(go);
     go->SetNewCellPosition(x, y, z, ang);
@@ -1107,6 +1542,7 @@ void Map::AddDynamicObjectToMoveList(DynamicObject* dynObj, float x, float y, fl
     if (_dynamicObjectsToMoveLock) //can this happen?
         return;
 
+    RegionGuard guard(this);
     if (dynObj->_moveState == MAP_OBJECT_CELL_MOVE_NONE)
         _dynamicObjectsToMove.push_back(dynObj);
     dynObj->SetNewCellPosition(x, y, z, ang);
@@ -1410,8 +1846,14 @@ bool Map::UnloadGrid(NGridType& ngrid, bool unloadAll)
 
             if (ActiveObjectsNearGrid(ngrid))
                 return false;
+
+            if (ngrid.GetGridState() != GRID_STATE_RETAINED && RetainGrid(ngrid))
+                return true;
         }
 
+        ForgetRetainedGrid(ngrid);
+        ++_gridUnloadCount;
+
         TC_LOG_DEBUG("maps", "Unloading grid[%u, %u] for map %u", x, y, GetId());
 
         if (!unloadAll)
@@ -1459,6 +1901,91 @@ bool Map::UnloadGrid(NGridType& ngrid, bool unloadAll)
     return true;
 }
 
+bool Map::RetainGrid(NGridType& ngrid)
+{
+    std::size_t budget = std::size_t(sWorld->getIntConfig(CONFIG_GRID_UNLOAD_RETAIN_BUDGET)) * 1024;
+    std::size_t memory = EstimateGridMemory(ngrid);
+    if (memory > budget)
+        return false;
+
+    // over budget grids are unloaded by TrimRetainedGrids once the grid state machine is done with this update
+    ngrid.SetGridState(GRID_STATE_RETAINED);
+    _retainedGrids.push_back({ uint32(ngrid.getX()), uint32(ngrid.getY()), memory });
+    _retainedGridsMemory += memory;
+    ++_gridRetainCount;
+
+    TC_LOG_DEBUG("maps", "Grid[%u, %u] on map %u retained instead of unloaded (%u KB)", ngrid.getX(), ngrid.getY(), GetId(), uint32(memory / 1024));
+    return true;
+}
+
+void Map::ForgetRetainedGrid(NGridType const& ngrid)
+{
+    if (ngrid.GetGridState() != GRID_STATE_RETAINED)
+        return;
+
+    auto itr = std::find_if(_retainedGrids.begin(), _retainedGrids.end(), [&ngrid](RetainedGrid const& retained)
+    {
+        return retained.X == uint32(ngrid.getX()) && retained.Y == uint32(ngrid.getY());
+    });
+
+    if (itr == _retainedGrids.end())
+        return;
+
+    _retainedGridsMemory -= itr->Memory;
+    _retainedGrids.erase(itr);
+}
+
+void Map::TrimRetainedGrids()
+{
+    std::size_t budget = std::size_t(sWorld->getIntConfig(CONFIG_GRID_UNLOAD_RETAIN_BUDGET)) * 1024;
+    while (_retainedGridsMemory > budget && !_retainedGrids.empty())
+    {
+        RetainedGrid oldest = _retainedGrids.front();
+        NGridType* grid = getNGrid(oldest.X, oldest.Y);
+        ASSERT(grid && grid->GetGridState() == GRID_STATE_RETAINED);
+
+        if (!UnloadGrid(*grid, false))
+        {
+            // something came close since, go through the removal delay again
+            ForgetRetainedGrid(*grid);
+            grid->SetGridState(GRID_STATE_REMOVAL);
+            ResetGridExpiry(*grid);
+        }
+    }
+}
+
+std::size_t Map::EstimateGridMemory(NGridType const& ngrid) const
+{
+    // only the objects themselves, what they allocate on their own is not accounted
+    static constexpr std::array<std::size_t, CELL_OCCUPANCY_WORLD_SHIFT> ObjectSizes =
+    {
+        sizeof(Corpse), sizeof(Creature), sizeof(DynamicObject), sizeof(GameObject), sizeof(Player), sizeof(AreaTrigger)
+    };
+
+    std::size_t memory = 0;
+    for (uint32 type = 0; type < CELL_OCCUPANCY_TYPE_COUNT; ++type)
+        memory += _cellOccupancy.GetGridCount(ngrid.getX(), ngrid.getY(), uint16(1 << type)) * ObjectSizes[type % CELL_OCCUPANCY_WORLD_SHIFT];
+
+    return memory;
+}
+
+void Map::SendGridMetrics()
+{
+    if (_gridLoadCount || _gridUnloadCount || _gridRetainCount || _gridReuseCount)
+    {
+        TC_METRIC_VALUE(Trinity::StringFormat("map_grid_loads,map_id=%u,instance_id=%u", GetId(), GetInstanceId()), _gridLoadCount);
+        TC_METRIC_VALUE(Trinity::StringFormat("map_grid_unloads,map_id=%u,instance_id=%u", GetId(), GetInstanceId()), _gridUnloadCount);
+        TC_METRIC_VALUE(Trinity::StringFormat("map_grid_retains,map_id=%u,instance_id=%u", GetId(), GetInstanceId()), _gridRetainCount);
+        TC_METRIC_VALUE(Trinity::StringFormat("map_grid_reuses,map_id=%u,instance_id=%u", GetId(), GetInstanceId()), _gridReuseCount);
+        TC_METRIC_VALUE(Trinity::StringFormat("map_grid_retained_memory,map_id=%u,instance_id=%u", GetId(), GetInstanceId()), uint64(_retainedGridsMemory));
+    }
+
+    _gridLoadCount = 0;
+    _gridUnloadCount = 0;
+    _gridRetainCount = 0;
+    _gridReuseCount = 0;
+}
+
 void Map::RemoveAllPlayers()
 {
     if (HavePlayers())
@@ -1810,12 +2337,14 @@ void Map::SendObjectUpdates()
         obj->BuildUpdate(update_players);
     }
 
-    WorldPacket packet;                                     // here we allocate a std::vector with a size of 0x10000
+    std::vector<WorldPacket> packets;
     for (UpdateDataMapType::iterator iter = update_players.begin(); iter != update_players.end(); ++iter)
     {
-        iter->second.BuildPacket(&packet);
-        iter->first->SendDirectMessage(&packet);
-        packet.clear();                                     // clean the string
+        iter->second.BuildPackets(packets, iter->first);
+        for (WorldPacket const& packet : packets)
+            iter->first->SendDirectMessage(&packet);
+
+        packets.clear();
     }
 }
 
@@ -1894,6 +2423,8 @@ bool Map::CheckRespawn(RespawnInfo* info)
 
 void Map::Respawn(RespawnInfo* info, CharacterDatabaseTransaction dbTrans)
 {
+    RegionGuard guard(this);
+    RequestWakeUp();
     if (info->respawnTime <= GameTime::GetGameTime())
         return;
     info->respawnTime = GameTime::GetGameTime();
@@ -1966,6 +2497,7 @@ static void PushRespawnInfoFrom(std::vector<RespawnInfo const*>& data, RespawnIn
 
 void Map::GetRespawnInfo(std::vector<RespawnInfo const*>& respawnData, SpawnObjectTypeMask types) const
 {
+    RegionGuard guard(this);
     if (types & SPAWN_TYPEMASK_CREATURE)
         PushRespawnInfoFrom(respawnData, _creatureRespawnTimesBySpawnId);
     if (types & SPAWN_TYPEMASK_GAMEOBJECT)
@@ -1974,6 +2506,7 @@ void Map::GetRespawnInfo(std::vector<RespawnInfo const*>& respawnData, SpawnObje
 
 RespawnInfo* Map::GetRespawnInfo(SpawnObjectType type, ObjectGuid::LowType spawnId) const
 {
+    RegionGuard guard(this);
     RespawnInfoMap const& map = GetRespawnMapForType(type);
     auto it = map.find(spawnId);
     if (it == map.end())
@@ -1992,6 +2525,7 @@ void Map::UnloadAllRespawnInfos() // delete everything from memory
 
 void Map::DeleteRespawnInfo(RespawnInfo* info, CharacterDatabaseTransaction dbTrans)
 {
+    RegionGuard guard(this);
     // Delete from all relevant containers to ensure consistency
     ASSERT(info);
 
@@ -2330,6 +2864,7 @@ void Map::UpdateSpawnGroupConditions()
 void Map::AddFarSpellCallback(FarSpellCallback&& callback)
 {
     _farSpellCallbacks.Enqueue(new FarSpellCallback(std::move(callback)));
+    RequestWakeUp();
 }
 
 void Map::DelayedUpdate(uint32 t_diff)
@@ -2357,6 +2892,15 @@ void Map::DelayedUpdate(uint32 t_diff)
             ASSERT(grid->GetGridState() >= 0 && grid->GetGridState() < MAX_GRID_STATE);
             si_GridStates[grid->GetGridState()]->Update(*this, *grid, *info, t_diff);
         }
+
+        TrimRetainedGrids();
+    }
+
+    _gridMetricsTimer.Update(t_diff);
+    if (_gridMetricsTimer.Passed())
+    {
+        _gridMetricsTimer.Reset();
+        SendGridMetrics();
     }
 }
 
@@ -2367,7 +2911,9 @@ void Map::AddObjectToRemoveList(WorldObject* obj)
     obj->SetDestroyedObject(true);
     obj->CleanupsBeforeDelete(false);                            // remove or simplify at least cross referenced links
 
+    RegionGuard guard(this);
     i_objectsToRemove.insert(obj);
+    RequestWakeUp();
     //TC_LOG_DEBUG("maps", "Object (GUID: %u TypeId: %u) added to removing list.", obj->GetGUID().GetCounter(), obj->GetTypeId());
 }
 
@@ -2379,6 +2925,8 @@ void Map::AddObjectToSwitchList(WorldObject* obj, bool on)
     if (obj->GetTypeId() != TYPEID_UNIT && obj->GetTypeId() != TYPEID_GAMEOBJECT)
         return;
 
+    RegionGuard guard(this);
+    RequestWakeUp();
     std::map<WorldObject*, bool>::iterator itr = i_objectsToSwitch.find(obj);
     if (itr == i_objectsToSwitch.end())
         i_objectsToSwitch.insert(itr, std::make_pair(obj, on));
@@ -2477,6 +3025,106 @@ void Map::SendToPlayers(WorldPacket const* data) const
         itr->GetSource()->SendDirectMessage(data);
 }
 
+void Map::RecordUpdateCost(uint32 microseconds)
+{
+    _lastUpdateCost = microseconds;
+
+    // exponential moving average over roughly the last 8 updates, seeded by the first sample
+    if (!_averageUpdateCost)
+        _averageUpdateCost = microseconds;
+    else
+        _averageUpdateCost = uint32((uint64(_averageUpdateCost) * 7 + microseconds) / 8);
+
+    UpdateDegradationLevel();
+}
+
+void Map::UpdateDegradationLevel()
+{
+    uint32 budget = sWorld->getIntConfig(CONFIG_MAP_UPDATE_FRAME_BUDGET) * 1000;
+    MapDegradationLevel level = _degradationLevel;
+    if (!budget)
+        level = MAP_DEGRADATION_NONE;
+    else if (_degradationCooldown)
+    {
+        --_degradationCooldown;
+        return;
+    }
+    else if (_averageUpdateCost > budget && level + 1 < MAX_MAP_DEGRADATION_LEVEL)
+        level = MapDegradationLevel(level + 1);
+    else if (_averageUpdateCost < budget / 2 && level > MAP_DEGRADATION_NONE)
+        level = MapDegradationLevel(level - 1);
+
+    if (level == _degradationLevel)
+        return;
+
+    TC_LOG_INFO("maps", "Map %u (instance %u) degradation level %u -> %u, average update %u us for a budget of %u us",
+        GetId(), GetInstanceId(), uint32(_degradationLevel), uint32(level), _averageUpdateCost, budget);
+    TC_METRIC_VALUE(Trinity::StringFormat("map_degradation_level,map_id=%u,instance_id=%u", GetId(), GetInstanceId()), uint32(level));
+
+    _degradationLevel = level;
+    // give the moving average time to reflect the new level
+    _degradationCooldown = 8;
+}
+
+uint32 Map::GetEstimatedUpdateCost() const
+{
+    if (_averageUpdateCost)
+        return _averageUpdateCost;
+
+    // no history yet, guess from what the last update had to process
+    return uint32(m_mapRefManager.getSize() * 100 + _markedCellIds.size() * 20 + m_activeNonPlayers.size() * 20);
+}
+
+bool Map::CanHibernate() const
+{
+    if (HavePlayers() || !m_activeNonPlayers.empty() || !_transports.empty() || IsBattlegroundOrArena())
+        return false;
+
+    if (!m_scriptSchedule.empty() || !i_objectsToRemove.empty() || !i_objectsToSwitch.empty())
+        return false;
+
+    return !_wakeUpRequested;
+}
+
+uint32 Map::GetHibernationDelay() const
+{
+    uint32 delay = sWorld->getIntConfig(CONFIG_MAP_HIBERNATION_MAX_SLEEP);
+
+    if (m_unloadTimer)
+        delay = std::min(delay, m_unloadTimer);
+
+    if (!_respawnTimes->empty())
+    {
+        time_t now = GameTime::GetGameTime();
+        time_t respawnTime = _respawnTimes->top()->respawnTime;
+        delay = std::min<uint32>(delay, respawnTime > now ? uint32(respawnTime - now) * IN_MILLISECONDS : 0);
+    }
+
+    return delay;
+}
+
+void Map::Hibernate()
+{
+    ASSERT(!_hibernating);
+
+    TC_LOG_DEBUG("maps", "Map %u (instance %u) hibernates for at most %u ms", GetId(), GetInstanceId(), GetHibernationDelay());
+
+    _hibernating = true;
+    ++_hibernationGeneration;
+    _hibernationStartTime = GameTime::GetGameTimeMS();
+}
+
+uint32 Map::WakeUp()
+{
+    ASSERT(_hibernating);
+
+    _hibernating = false;
+    uint32 hibernatedTime = getMSTimeDiff(_hibernationStartTime, GameTime::GetGameTimeMS());
+
+    TC_LOG_DEBUG("maps", "Map %u (instance %u) wakes up after %u ms", GetId(), GetInstanceId(), hibernatedTime);
+    return hibernatedTime;
+}
+
 bool Map::ActiveObjectsNearGrid(NGridType const& ngrid) const
 {
     CellCoord cell_min(ngrid.getX() * MAX_NUMBER_OF_CELLS, ngrid.getY() * MAX_NUMBER_OF_CELLS);
@@ -2516,6 +3164,9 @@ bool Map::ActiveObjectsNearGrid(NGridType const& ngrid) const
 
 void Map::AddToActive(WorldObject* obj)
 {
+    RegionGuard guard(this);
+    RequestWakeUp();
+
     AddToActiveHelper(obj);
 
     Optional<Position> respawnLocation;
@@ -2555,6 +3206,8 @@ void Map::AddToActive(WorldObject* obj)
 
 void Map::RemoveFromActive(WorldObject* obj)
 {
+    RegionGuard guard(this);
+
     RemoveFromActiveHelper(obj);
 
     Optional<Position> respawnLocation;
@@ -3160,26 +3813,31 @@ Player* Map::GetPlayer(ObjectGuid const& guid)
 
 AreaTrigger* Map::GetAreaTrigger(ObjectGuid const& guid)
 {
+    RegionGuard guard(this);
     return _objectsStore.Find<AreaTrigger>(guid);
 }
 
 Corpse* Map::GetCorpse(ObjectGuid const& guid)
 {
+    RegionGuard guard(this);
     return _objectsStore.Find<Corpse>(guid);
 }
 
 Creature* Map::GetCreature(ObjectGuid const& guid)
 {
+    RegionGuard guard(this);
     return _objectsStore.Find<Creature>(guid);
 }
 
 DynamicObject* Map::GetDynamicObject(ObjectGuid const& guid)
 {
+    RegionGuard guard(this);
     return _objectsStore.Find<DynamicObject>(guid);
 }
 
 Creature* Map::GetCreatureBySpawnId(ObjectGuid::LowType spawnId) const
 {
+    RegionGuard guard(this);
     auto const bounds = GetCreatureBySpawnIdStore().equal_range(spawnId);
     if (bounds.first == bounds.second)
         return nullptr;
@@ -3194,6 +3852,7 @@ Creature* Map::GetCreatureBySpawnId(ObjectGuid::LowType spawnId) const
 
 GameObject* Map::GetGameObjectBySpawnId(ObjectGuid::LowType spawnId) const
 {
+    RegionGuard guard(this);
     auto const bounds = GetGameObjectBySpawnIdStore().equal_range(spawnId);
     if (bounds.first == bounds.second)
         return nullptr;
@@ -3208,11 +3867,13 @@ GameObject* Map::GetGameObjectBySpawnId(ObjectGuid::LowType spawnId) const
 
 GameObject* Map::GetGameObject(ObjectGuid const& guid)
 {
+    RegionGuard guard(this);
     return _objectsStore.Find<GameObject>(guid);
 }
 
 Pet* Map::GetPet(ObjectGuid const& guid)
 {
+    RegionGuard guard(this);
     return _objectsStore.Find<Pet>(guid);
 }
 
@@ -3233,6 +3894,7 @@ void Map::UpdateIteratorBack(Player* player)
 
 void Map::SaveRespawnTime(SpawnObjectType type, ObjectGuid::LowType spawnId, uint32 entry, time_t respawnTime, uint32 gridId, CharacterDatabaseTransaction dbTrans, bool startup)
 {
+    RegionGuard guard(this);
     SpawnMetadata const* data = sObjectMgr->GetSpawnMetadata(type, spawnId);
     if (!data)
     {
@@ -3660,6 +4322,7 @@ int32 Map::GetWorldStateValue(int32 worldStateId) const
 
 void Map::SetWorldStateValue(int32 worldStateId, int32 value, bool hidden)
 {
+    RegionGuard guard(this);
     auto [itr, inserted] = _worldStateValues.try_emplace(worldStateId, 0);
     int32 oldValue = itr->second;
     if (oldValue == value && !inserted)
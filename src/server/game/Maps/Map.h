@@ -21,6 +21,7 @@
 #include "Define.h"
 
 #include "Cell.h"
+#include "CellOccupancy.h"
 #include "DynamicTree.h"
 #include "GridDefines.h"
 #include "GridRefManager.h"
@@ -35,9 +36,12 @@
 #include "WorldStateDefines.h"
 #include "Transaction.h"
 #include "Weather.h"
+#include <atomic>
 #include <bitset>
+#include <functional>
 #include <list>
 #include <memory>
+#include <mutex>
 
 class Battleground;
 class BattlegroundMap;
@@ -59,12 +63,13 @@ class WorldObject;
 class WorldPacket;
 struct MapDifficulty;
 struct MapEntry;
+struct MapRegionUpdateContext;
 struct Position;
 struct ScriptAction;
 struct ScriptInfo;
 struct SummonPropertiesEntry;
 enum Difficulty : uint8;
-namespace Trinity { struct ObjectUpdater; }
+namespace Trinity { struct DeferredRelocationWork; struct ObjectUpdater; }
 namespace VMAP { enum class ModelIgnoreFlags : uint32; }
 
 namespace WorldPackets
@@ -109,6 +114,16 @@ struct ZoneDynamicInfo
 #define MIN_UNLOAD_DELAY      1                             // immediate unload
 #define MAP_INVALID_ZONE      0xFFFFFFFF
 
+// Graded work shedding of a map running over its frame budget, every level includes the previous ones
+enum MapDegradationLevel : uint8
+{
+    MAP_DEGRADATION_NONE        = 0,
+    MAP_DEGRADATION_RELOCATION  = 1,                        // relocation notifies at half rate, far aura casters every 4th tick
+    MAP_DEGRADATION_STAGGER     = 2,                        // marked cells updated every other tick
+    MAP_DEGRADATION_SCRIPTS     = 3,                        // map scripts processed every 4th tick
+    MAX_MAP_DEGRADATION_LEVEL
+};
+
 typedef std::map<uint32/*leaderDBGUID*/, CreatureGroup*>        CreatureGroupHolderType;
 
 struct RespawnInfo; // forward declaration
@@ -188,7 +203,9 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
         template<class T> bool AddToMap(T *);
         template<class T> void RemoveFromMap(T *, bool);
 
-        void VisitNearbyCellsOf(WorldObject* obj, TypeContainerVisitor<Trinity::ObjectUpdater, GridTypeMapContainer> &gridVisitor, TypeContainerVisitor<Trinity::ObjectUpdater, WorldTypeMapContainer> &worldVisitor);
+        void MarkNearbyCellsOf(WorldObject* obj);
+        void MarkCellsNearPlayer(WorldObject* obj);
+        bool IsCellNearPlayer(uint32 cellId) const { return _nearPlayerCells.test(cellId); }
         virtual void Update(uint32);
 
         float GetVisibilityRange() const { return m_VisibleDistance; }
@@ -203,6 +220,10 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
         template<class T, class CONTAINER>
         void Visit(Cell const& cell, TypeContainerVisitor<T, CONTAINER> &visitor);
 
+        // Broad phase over the packed cell indexes of already loaded grids, see CellSpatialIndex::Visit
+        template<typename Visitor>
+        void VisitIndexedObjects(float x, float y, float radius, uint32 typeMask, uint8 containerMask, uint32 phaseSummary, Visitor&& visit) const;
+
         bool IsRemovalGrid(float x, float y) const
         {
             GridCoord p = Trinity::ComputeGridCoord(x, y);
@@ -219,6 +240,11 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
         void LoadGrid(float x, float y);
         void LoadAllCells();
         bool UnloadGrid(NGridType& ngrid, bool pForce);
+        bool RetainGrid(NGridType& ngrid);
+        void ForgetRetainedGrid(NGridType const& ngrid);
+        void TrimRetainedGrids();
+        std::size_t EstimateGridMemory(NGridType const& ngrid) const;
+        void SendGridMetrics();
         void GridMarkNoUnload(uint32 x, uint32 y);
         void GridUnmarkNoUnload(uint32 x, uint32 y);
         virtual void UnloadAll();
@@ -329,16 +355,34 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
         void AddObjectToSwitchList(WorldObject* obj, bool on);
         virtual void DelayedUpdate(uint32 diff);
 
-        void resetMarkedCells() { marked_cells.reset(); }
+        void resetMarkedCells() { marked_cells.reset(); _markedCellIds.clear(); }
         bool isCellMarked(uint32 pCellId) { return marked_cells.test(pCellId); }
         void markCell(uint32 pCellId) { marked_cells.set(pCellId); }
 
         bool HavePlayers() const { return !m_mapRefManager.isEmpty(); }
         uint32 GetPlayersCountExceptGMs() const;
+
+        // Update cost bookkeeping, MapUpdater dispatches the most expensive maps first
+        void RecordUpdateCost(uint32 microseconds);
+        uint32 GetLastUpdateCost() const { return _lastUpdateCost; }
+        uint32 GetAverageUpdateCost() const { return _averageUpdateCost; }
+        uint32 GetEstimatedUpdateCost() const;
+        MapDegradationLevel GetDegradationLevel() const { return _degradationLevel; }
+
+        // Hibernation, maps without players or active objects leave the update loop
+        // until one of their timers is due or something happens on them
+        bool CanHibernate() const;
+        uint32 GetHibernationDelay() const;
+        void Hibernate();
+        uint32 WakeUp();                                    // returns the time spent hibernating
+        bool IsHibernating() const { return _hibernating; }
+        uint32 GetHibernationGeneration() const { return _hibernationGeneration; }
+        void RequestWakeUp() { _wakeUpRequested = true; }
+        bool IsWakeUpRequested() const { return _wakeUpRequested; }
         bool ActiveObjectsNearGrid(NGridType const& ngrid) const;
 
-        void AddWorldObject(WorldObject* obj) { i_worldObjects.insert(obj); }
-        void RemoveWorldObject(WorldObject* obj) { i_worldObjects.erase(obj); }
+        void AddWorldObject(WorldObject* obj) { RegionGuard guard(this); i_worldObjects.insert(obj); }
+        void RemoveWorldObject(WorldObject* obj) { RegionGuard guard(this); i_worldObjects.erase(obj); }
 
         void SendToPlayers(WorldPacket const* data) const;
 
@@ -428,10 +472,10 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
         BattlegroundMap const* ToBattlegroundMap() const { if (IsBattlegroundOrArena()) return reinterpret_cast<BattlegroundMap const*>(this); return nullptr; }
 
         bool isInLineOfSight(PhaseShift const& phaseShift, float x1, float y1, float z1, float x2, float y2, float z2, LineOfSightChecks checks, VMAP::ModelIgnoreFlags ignoreFlags) const;
-        void Balance() { _dynamicTree.balance(); }
-        void RemoveGameObjectModel(const GameObjectModel& model) { _dynamicTree.remove(model); }
-        void InsertGameObjectModel(const GameObjectModel& model) { _dynamicTree.insert(model); }
-        bool ContainsGameObjectModel(const GameObjectModel& model) const { return _dynamicTree.contains(model);}
+        void Balance();
+        void RemoveGameObjectModel(const GameObjectModel& model);
+        void InsertGameObjectModel(const GameObjectModel& model);
+        bool ContainsGameObjectModel(const GameObjectModel& model) const;
         float GetGameObjectFloor(PhaseShift const& phaseShift, float x, float y, float z, float maxSearchDist = DEFAULT_HEIGHT_SEARCH) const
         {
             return _dynamicTree.getHeight(x, y, z, maxSearchDist, phaseShift);
@@ -445,6 +489,7 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
         time_t GetLinkedRespawnTime(ObjectGuid guid) const;
         time_t GetRespawnTime(SpawnObjectType type, ObjectGuid::LowType spawnId) const
         {
+            RegionGuard guard(this);
             auto const& map = GetRespawnMapForType(type);
             auto it = map.find(spawnId);
             return (it == map.end()) ? 0 : it->second->respawnTime;
@@ -486,6 +531,7 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
         inline ObjectGuid::LowType GenerateLowGuid()
         {
             static_assert(ObjectGuidTraits<high>::MapSpecific, "Only map specific guid can be generated in Map context");
+            RegionGuard guard(this);
             return GetGuidSequenceGenerator<high>().Generate();
         }
 
@@ -493,19 +539,45 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
         inline ObjectGuid::LowType GetMaxLowGuid()
         {
             static_assert(ObjectGuidTraits<high>::MapSpecific, "Only map specific guid can be retrieved in Map context");
+            RegionGuard guard(this);
             return GetGuidSequenceGenerator<high>().GetNextAfterMaxUsed();
         }
 
         void AddUpdateObject(Object* obj)
         {
+            RegionGuard guard(this);
             _updateObjects.insert(obj);
         }
 
         void RemoveUpdateObject(Object* obj)
         {
+            RegionGuard guard(this);
             _updateObjects.erase(obj);
         }
 
+        /*
+            REGION UPDATES
+            Large continents can update their marked cells grid by grid on the region update pool.
+            Grids are split in nine colors so that grids updated at the same time are three grids apart,
+            the two untouched grids between them act as halos that only one of the regions reaches.
+            Map wide containers are protected by RegionGuard, dynamic tree changes are deferred
+            to the merge that follows every color pass so that line of sight queries stay lock free.
+        */
+        class RegionGuard
+        {
+            public:
+                explicit RegionGuard(Map const* map) : _lock(map->_regionLock, std::defer_lock)
+                {
+                    if (map->_regionUpdateActive)
+                        _lock.lock();
+                }
+
+            private:
+                std::unique_lock<std::recursive_mutex> _lock;
+        };
+
+        bool IsRegionUpdateActive() const { return _regionUpdateActive; }
+
     private:
         void SetTimer(uint32 t) { i_gridExpiry = t < MIN_GRID_DELAY ? MIN_GRID_DELAY : t; }
 
@@ -540,6 +612,13 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
         bool EnsureGridLoaded(Cell const&);
         void EnsureGridLoadedForActiveObject(Cell const&, WorldObject* object);
 
+        // map files of grids ahead of moving players are read on the executor, everything else is loaded on the map thread
+        // once a player gets close to the grid
+        struct GridPreload;
+        void PreloadGridAhead(Unit const* unit);
+        bool IsGridNearPlayers(GridCoord const& p) const;
+        void LinkPreloadedGrids();
+
         void buildNGridLinkage(NGridType* pNGridType) { pNGridType->link(this); }
 
         NGridType* getNGrid(uint32 x, uint32 y) const
@@ -556,6 +635,16 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
 
         void SendObjectUpdates();
 
+        void UpdateMarkedCells(uint32 diff);
+        void UpdateCellIds(std::vector<uint32> const& cellIds, uint32 diff);
+        bool CanUpdateInRegions() const;
+        void UpdateCellIdsInRegions(std::vector<uint32> const& cellIds, uint32 diff);
+        void MergeRegionUpdateContext(MapRegionUpdateContext& context);
+        void RunRegionsInParallel(std::size_t count, std::function<void(std::size_t)> const& work);
+
+        template<class T, class CONTAINER>
+        static uint16 GetVisitedOccupancyTypes(TypeContainerVisitor<T, CONTAINER> const& visitor);
+
     protected:
 
         MapEntry const* i_mapEntry;
@@ -564,6 +653,7 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
         uint32 m_unloadTimer;
         float m_VisibleDistance;
         DynamicMapTree _dynamicTree;
+        CellOccupancy _cellOccupancy;
 
         MapRefManager m_mapRefManager;
         MapRefManager::iterator m_mapRefIter;
@@ -597,10 +687,20 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
 
         NGridType* i_grids[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
         std::bitset<TOTAL_NUMBER_OF_CELLS_PER_MAP*TOTAL_NUMBER_OF_CELLS_PER_MAP> marked_cells;
+        std::vector<uint32> _markedCellIds;                 // cells marked this tick, in marking order
+        std::bitset<TOTAL_NUMBER_OF_CELLS_PER_MAP*TOTAL_NUMBER_OF_CELLS_PER_MAP> _nearPlayerCells; // cells updated at full rate, only used for far creature updates
+        std::vector<Unit*> _farUnitsToMark;                 // out of range combat partners and aura casters of this tick
+        std::size_t _farUnitCellsBegin;                     // range of _markedCellIds only marked for _farUnitsToMark
+        std::size_t _farUnitCellsEnd;
+
+        bool _regionUpdateActive;
+        mutable std::recursive_mutex _regionLock;
 
         //these functions used to process player/mob aggro reactions and
         //visibility calculations. Highly optimized for massive calculations
         void ProcessRelocationNotifies(uint32 diff);
+        void NotifyRelocationsInCell(uint32 cellId, Trinity::DeferredRelocationWork* deferred);
+        void NotifyRelocationsInRegions(std::unordered_map<uint32, std::vector<uint32>> const& relocationGrids);
 
         bool i_scriptLock;
         std::set<WorldObject*> i_objectsToRemove;
@@ -730,6 +830,46 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
         std::unordered_set<uint32> _toggledSpawnGroupIds;
 
         uint32 _respawnCheckTimer;
+
+        uint32 _lastUpdateCost;                             // microseconds
+        uint32 _averageUpdateCost;                          // microseconds, moving average
+
+        void UpdateDegradationLevel();
+
+        MapDegradationLevel _degradationLevel;
+        uint32 _degradationCooldown;                        // updates before the level may change again
+        uint32 _updateTick;
+
+        // cells that waited in the previous tick of the stagger level, they catch up on its time when marked again
+        std::bitset<TOTAL_NUMBER_OF_CELLS_PER_MAP*TOTAL_NUMBER_OF_CELLS_PER_MAP> _staggerWaitingCells;
+        std::vector<uint32> _staggerWaitingCellIds;
+        std::vector<uint32> _staggerNextWaitingCellIds;
+        std::vector<uint32> _staggerCatchUpCellIds;
+        uint32 _staggerWaitedDiff;
+
+        bool _hibernating;
+        std::atomic<bool> _wakeUpRequested;                 // set from any thread, see RequestWakeUp
+        uint32 _hibernationGeneration;
+        uint32 _hibernationStartTime;
+
+        std::unordered_map<uint32 /*gridId*/, std::shared_ptr<GridPreload>> _gridPreloads;
+
+        // grids whose unload was postponed, least recently retained first
+        struct RetainedGrid
+        {
+            uint32 X;
+            uint32 Y;
+            std::size_t Memory;
+        };
+        std::list<RetainedGrid> _retainedGrids;
+        std::size_t _retainedGridsMemory;
+
+        // grid churn since the last metrics report
+        uint32 _gridLoadCount;
+        uint32 _gridUnloadCount;
+        uint32 _gridRetainCount;
+        uint32 _gridReuseCount;
+        IntervalTimer _gridMetricsTimer;
         std::unordered_map<uint32, uint32> _zonePlayerCountMap;
 
         ZoneDynamicInfoMap _zoneDynamicInfo;
@@ -844,10 +984,47 @@ inline void Map::Visit(Cell const& cell, TypeContainerVisitor<T, CONTAINER>& vis
     const uint32 cell_x = cell.CellX();
     const uint32 cell_y = cell.CellY();
 
+    // cells without anything the visitor looks at are skipped without touching their grid,
+    // unless the visit may have to load it first
+    if (cell.NoCreate() && !(_cellOccupancy.GetCellTypes(cell.GetCellCoord()) & GetVisitedOccupancyTypes(visitor)))
+        return;
+
     if (!cell.NoCreate() || IsGridLoaded(GridCoord(x, y)))
     {
         EnsureGridLoaded(cell);
         getNGrid(x, y)->VisitGrid(cell_x, cell_y, visitor);
     }
 }
+
+template<class T, class CONTAINER>
+inline uint16 Map::GetVisitedOccupancyTypes(TypeContainerVisitor<T, CONTAINER> const& visitor)
+{
+    // searchers restricted to some object types carry a GridMapTypeMask
+    if constexpr (requires { visitor.GetVisitor().i_mapTypeMask; })
+        return CellOccupancy::GetContainerTypes<CONTAINER>(visitor.GetVisitor().i_mapTypeMask);
+    else
+        return CellOccupancy::GetContainerTypes<CONTAINER>(GRID_MAP_TYPE_MASK_ALL);
+}
+
+template<typename Visitor>
+inline void Map::VisitIndexedObjects(float x, float y, float radius, uint32 typeMask, uint8 containerMask, uint32 phaseSummary, Visitor&& visit) const
+{
+    CellCoord const center = Trinity::ComputeCellCoord(x, y);
+    if (!center.IsCoordValid())
+        return;
+
+    radius = std::min(radius, SIZE_OF_GRIDS);
+    CellArea const area = Cell::CalculateCellArea(x, y, radius);
+    for (uint32 cellX = area.low_bound.x_coord; cellX <= area.high_bound.x_coord; ++cellX)
+    {
+        for (uint32 cellY = area.low_bound.y_coord; cellY <= area.high_bound.y_coord; ++cellY)
+        {
+            Cell const cell(CellCoord(cellX, cellY));
+            if (!IsGridLoaded(GridCoord(cell.GridX(), cell.GridY())))
+                continue;
+
+            getNGrid(cell.GridX(), cell.GridY())->GetCellIndex(cell.CellX(), cell.CellY()).Visit(x, y, radius, typeMask, containerMask, phaseSummary, visit);
+        }
+    }
+}
 #endif
@@ -17,6 +17,7 @@
 
 #include "MapManager.h"
 #include "Battleground.h"
+#include "Config.h"
 #include "Containers.h"
 #include "DatabaseEnv.h"
 #include "DBCStores.h"
@@ -27,13 +28,16 @@
 #include "ObjectMgr.h"
 #include "Player.h"
 #include "ScriptMgr.h"
+#include "WorkStealingExecutor.h"
 #include "World.h"
 #include "WorldStateMgr.h"
 #include <boost/dynamic_bitset.hpp>
+#include <chrono>
 #include <numeric>
 
 MapManager::MapManager()
-    : _freeInstanceIds(std::make_unique<InstanceIds>()), _nextInstanceId(0), _scheduledScripts(0)
+    : _freeInstanceIds(std::make_unique<InstanceIds>()), _nextInstanceId(0),
+    _hibernationWheel(sWorld->getIntConfig(CONFIG_INTERVAL_MAPUPDATE)), _scheduledScripts(0)
 {
     i_gridCleanUpDelay = sWorld->getIntConfig(CONFIG_INTERVAL_GRIDCLEAN);
     i_timer.SetInterval(sWorld->getIntConfig(CONFIG_INTERVAL_MAPUPDATE));
@@ -49,6 +53,19 @@ void MapManager::Initialize()
     // Start mtmaps if needed.
     if (num_threads > 0)
         m_updater.activate(num_threads);
+
+    Tokenizer warmMapIds(sConfigMgr->GetStringDefault("Instance.WarmPool.Maps", ""), ' ');
+    for (char const* mapId : warmMapIds)
+    {
+        MapEntry const* entry = sMapStore.LookupEntry(atoul(mapId));
+        if (!entry || (!entry->IsDungeon() && !entry->IsBattlegroundOrArena()))
+        {
+            TC_LOG_ERROR("server.loading", "Instance.WarmPool.Maps: map %s is not a dungeon or battleground, skipped.", mapId);
+            continue;
+        }
+
+        _warmMapIds.insert(entry->ID);
+    }
 }
 
 void MapManager::InitializeVisibilityDistanceInfo()
@@ -81,6 +98,13 @@ Map* MapManager::CreateWorldMap(uint32 mapId, uint32 instanceId)
 }
 
 InstanceMap* MapManager::CreateInstance(uint32 mapId, uint32 instanceId, InstanceSave* save, Difficulty difficulty, TeamId team)
+{
+    InstanceMap* map = ConstructInstance(mapId, instanceId, save != nullptr, difficulty, team);
+    LoadInstance(map, save != nullptr);
+    return map;
+}
+
+InstanceMap* MapManager::ConstructInstance(uint32 mapId, uint32 instanceId, bool hasSave, Difficulty difficulty, TeamId team)
 {
     // make sure we have a valid map id
     MapEntry const* entry = sMapStore.LookupEntry(mapId);
@@ -93,21 +117,22 @@ InstanceMap* MapManager::CreateInstance(uint32 mapId, uint32 instanceId, Instanc
     // some instances only have one difficulty
     sDBCManager.GetDownscaledMapDifficultyData(mapId, difficulty);
 
-    TC_LOG_DEBUG("maps", "MapInstanced::CreateInstance: %s map instance %d for %d created with difficulty %u", save ? "" : "new ", instanceId, mapId, static_cast<uint32>(difficulty));
+    TC_LOG_DEBUG("maps", "MapInstanced::CreateInstance: %s map instance %d for %d created with difficulty %u", hasSave ? "" : "new ", instanceId, mapId, static_cast<uint32>(difficulty));
 
     InstanceMap* map = new InstanceMap(mapId, i_gridCleanUpDelay, instanceId, difficulty, team);
     ASSERT(map->IsDungeon());
+    return map;
+}
 
+void MapManager::LoadInstance(InstanceMap* map, bool loadData)
+{
     map->LoadRespawnTimes();
     map->LoadCorpseData();
 
-    bool load_data = save != nullptr;
-    map->CreateInstanceData(load_data);
+    map->CreateInstanceData(loadData);
 
     if (sWorld->getBoolConfig(CONFIG_INSTANCEMAP_LOAD_GRIDS))
         map->LoadAllCells();
-
-    return map;
 }
 
 BattlegroundMap* MapManager::CreateBattleground(uint32 mapId, uint32 instanceId, Battleground* bg)
@@ -211,14 +236,20 @@ Map* MapManager::CreateMap(uint32 mapId, Player* player, uint32 loginInstanceId
             Difficulty diff = player->GetGroup() ? player->GetGroup()->GetDifficulty(entry->IsRaid()) : player->GetDifficulty(entry->IsRaid());
 
             // if no instanceId via group members or instance saves is found
-            // the instance will be created for the first time
-            newInstanceId = GenerateInstanceId();
+            // the instance will be created for the first time, or taken from the warm pool
+            map = TakeWarmMap({ mapId, diff, player->GetTeamId() });
+            if (map)
+                newInstanceId = map->GetInstanceId();
+            else
+            {
+                newInstanceId = GenerateInstanceId();
 
-            //Seems it is now possible, but I do not know if it should be allowed
-            //ASSERT(!FindInstanceMap(NewInstanceId));
-            map = FindMap_i(mapId, newInstanceId);
-            if (!map)
-                map = CreateInstance(mapId, newInstanceId, nullptr, diff, player->GetTeamId());
+                //Seems it is now possible, but I do not know if it should be allowed
+                //ASSERT(!FindInstanceMap(NewInstanceId));
+                map = FindMap_i(mapId, newInstanceId);
+                if (!map)
+                    map = CreateInstance(mapId, newInstanceId, nullptr, diff, player->GetTeamId());
+            }
         }
     }
     else
@@ -238,6 +269,109 @@ Map* MapManager::CreateMap(uint32 mapId, Player* player, uint32 loginInstanceId
     return map;
 }
 
+Map* MapManager::TakeWarmMap(WarmMapKey const& key)
+{
+    if (!_warmMapIds.count(std::get<0>(key)))
+        return nullptr;
+
+    // a miss registers the key, the pool only warms the difficulties and teams that are actually requested
+    std::vector<Map*>& maps = _warmMaps[key];
+    if (maps.empty())
+        return nullptr;
+
+    Map* map = maps.back();
+    maps.pop_back();
+
+    TC_LOG_DEBUG("maps", "MapManager::TakeWarmMap: map %u instance %u taken from the warm pool", map->GetId(), map->GetInstanceId());
+    return map;
+}
+
+Map* MapManager::ConstructWarmMap(WarmMapKey const& key, uint32 instanceId)
+{
+    auto const& [mapId, difficulty, team] = key;
+    if (sMapStore.LookupEntry(mapId)->IsBattlegroundOrArena())
+        return new BattlegroundMap(mapId, i_gridCleanUpDelay, instanceId, REGULAR_DIFFICULTY);
+
+    return ConstructInstance(mapId, instanceId, false, difficulty, team);
+}
+
+void MapManager::LoadWarmMap(Map* map)
+{
+    InstanceMap* instance = map->ToInstanceMap();
+    if (!instance)
+        return;
+
+    LoadInstance(instance, false);
+
+    // every group starts at the entrance, its grid is the first one to be loaded on entry
+    if (AreaTriggerStruct const* entrance = sObjectMgr->GetMapEntranceTrigger(map->GetId()))
+        map->LoadGrid(entrance->target_X, entrance->target_Y);
+}
+
+void MapManager::RefillWarmMaps()
+{
+    uint32 const poolSize = sWorld->getIntConfig(CONFIG_INSTANCE_WARM_POOL_SIZE);
+
+    std::unique_lock<std::shared_mutex> lock(_mapsLock);
+    if (_warmMapJob)
+    {
+        if (!_warmMapJob->Ready.load(std::memory_order_acquire))
+            return;
+
+        _warmMaps[_warmMapJob->Key].push_back(_warmMapJob->WarmMap);
+        _warmMapJob.reset();
+    }
+
+    for (auto const& [key, maps] : _warmMaps)
+    {
+        if (maps.size() >= poolSize)
+            continue;
+
+        // the constructor registers the map with global managers and stays here, the database
+        // loads and grid loading run as a background job on the map executor
+        std::shared_ptr<WarmMapJob> job = std::make_shared<WarmMapJob>();
+        job->Key = key;
+        uint32 instanceId = GenerateInstanceId();
+
+        // maps in the pool are not visible to anyone, no need to hold the lock while creating them
+        lock.unlock();
+        job->WarmMap = ConstructWarmMap(job->Key, instanceId);
+
+        if (!m_updater.activated())
+        {
+            LoadWarmMap(job->WarmMap);
+            lock.lock();
+            _warmMaps[job->Key].push_back(job->WarmMap);
+            break;
+        }
+
+        m_updater.GetExecutor()->Post([job]()
+        {
+            LoadWarmMap(job->WarmMap);
+            job->Ready.store(true, std::memory_order_release);
+        }, Trinity::TaskPriority::Low);
+
+        // one map at a time, a burst of creations would compete with the map updates
+        lock.lock();
+        _warmMapJob = std::move(job);
+        break;
+    }
+}
+
+uint32 MapManager::AssignBattlegroundInstanceId(Battleground* bg)
+{
+    std::unique_lock<std::shared_mutex> lock(_mapsLock);
+
+    BattlegroundMap* map = static_cast<BattlegroundMap*>(TakeWarmMap({ bg->GetMapId(), REGULAR_DIFFICULTY, TEAM_NEUTRAL }));
+    if (!map)
+        return GenerateInstanceId();
+
+    map->SetBG(bg);
+    bg->SetBgMap(map);
+    i_maps[{ map->GetId(), map->GetInstanceId() }] = map;
+    return map->GetInstanceId();
+}
+
 Map* MapManager::FindMap(uint32 mapId, uint32 instanceId) const
 {
     std::shared_lock<std::shared_mutex> lock(_mapsLock);
@@ -341,31 +475,84 @@ void MapManager::Update(uint32 diff)
     if (!i_timer.Passed())
         return;
 
+    uint32 const mapDiff = uint32(i_timer.GetCurrent());
+
+    // hibernating maps are skipped entirely until the wheel or an event wakes them up
+    _hibernationWheel.Advance(mapDiff, [this](HibernationTimer const& timer)
+    {
+        if (Map* map = FindMap_i(timer.Key.first, timer.Key.second))
+            if (map->IsHibernating() && map->GetHibernationGeneration() == timer.Generation)
+                map->RequestWakeUp();
+    });
+
+    // delayed updates only touch their own map, with workers they can follow each map update directly
+    // instead of waiting for the slowest map of the tick
+    bool const pipelineDelayedUpdates = m_updater.activated() && sWorld->getBoolConfig(CONFIG_MAP_UPDATE_PIPELINE_DELAYED);
+
+    _updatedMaps.clear();
+
     MapMapType::iterator iter = i_maps.begin();
     while (iter != i_maps.end())
     {
-        if (iter->second->CanUnload(diff))
+        Map* map = iter->second;
+        uint32 updateDiff = mapDiff;
+        uint32 unloadDiff = diff;
+        if (map->IsHibernating())
         {
-            if (DestroyMap(iter->second))
+            if (!map->IsWakeUpRequested())
+            {
+                ++iter;
+                continue;
+            }
+
+            updateDiff = unloadDiff = map->WakeUp();
+        }
+
+        if (map->CanUnload(unloadDiff))
+        {
+            if (DestroyMap(map))
                 iter = i_maps.erase(iter);
             else
+            {
+                if (pipelineDelayedUpdates)
+                    map->DelayedUpdate(updateDiff);
+                _updatedMaps.emplace_back(map, updateDiff);
                 ++iter;
+            }
 
             continue;
         }
 
         if (m_updater.activated())
-            m_updater.schedule_update(*iter->second, uint32(i_timer.GetCurrent()));
+            m_updater.schedule_update(*map, updateDiff, pipelineDelayedUpdates);
         else
-            iter->second->Update(uint32(i_timer.GetCurrent()));
+        {
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            map->Update(updateDiff);
+            map->RecordUpdateCost(uint32(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count()));
+        }
 
+        _updatedMaps.emplace_back(map, updateDiff);
         ++iter;
     }
     if (m_updater.activated())
         m_updater.wait();
 
-    for (iter = i_maps.begin(); iter != i_maps.end(); ++iter)
-        iter->second->DelayedUpdate(uint32(i_timer.GetCurrent()));
+    bool const hibernation = sWorld->getBoolConfig(CONFIG_MAP_HIBERNATION);
+    for (std::pair<Map*, uint32> const& updated : _updatedMaps)
+    {
+        if (!pipelineDelayedUpdates)
+            updated.first->DelayedUpdate(updated.second);
+
+        if (hibernation && updated.first->CanHibernate())
+        {
+            updated.first->Hibernate();
+            _hibernationWheel.Schedule(updated.first->GetHibernationDelay(),
+                { { updated.first->GetId(), updated.first->GetInstanceId() }, updated.first->GetHibernationGeneration() });
+        }
+    }
+
+    RefillWarmMaps();
 
     i_timer.SetCurrent(0);
 }
@@ -404,9 +591,25 @@ void MapManager::UnloadAll()
 
     i_maps.clear();
 
+    // finishes the background load of a warm map before it is deleted
     if (m_updater.activated())
         m_updater.deactivate();
 
+    if (_warmMapJob)
+        _warmMaps[_warmMapJob->Key].push_back(_warmMapJob->WarmMap);
+    _warmMapJob.reset();
+
+    for (auto const& [key, maps] : _warmMaps)
+    {
+        for (Map* map : maps)
+        {
+            map->UnloadAll();
+            delete map;
+        }
+    }
+
+    _warmMaps.clear();
+
     Map::DeleteStateMachine();
 }
 
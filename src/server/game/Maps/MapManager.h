@@ -23,9 +23,13 @@
 #include "MapUpdater.h"
 #include "Position.h"
 #include "SharedDefines.h"
+#include "TimerWheel.h"
 #include <boost/dynamic_bitset_fwd.hpp>
 #include <map>
+#include <memory>
 #include <shared_mutex>
+#include <tuple>
+#include <unordered_set>
 
 class Battleground;
 class BattlegroundMap;
@@ -112,6 +116,9 @@ class TC_GAME_API MapManager
         void RegisterInstanceId(uint32 instanceId);
         void FreeInstanceId(uint32 instanceId);
 
+        // Instance id for a new battleground, binds a pre-created map of the warm pool to it when there is one
+        uint32 AssignBattlegroundInstanceId(Battleground* bg);
+
         MapUpdater * GetMapUpdater() { return &m_updater; }
 
         template<typename Worker>
@@ -130,14 +137,38 @@ class TC_GAME_API MapManager
     private:
         using MapKey = std::pair<uint32, uint32>;
         typedef std::map<MapKey, Map*> MapMapType;
+
+        struct HibernationTimer
+        {
+            MapKey Key;
+            uint32 Generation;                              // stale once the map woke up in between
+        };
         typedef boost::dynamic_bitset<size_t> InstanceIds;
 
+        // maps created ahead of demand, unbound and not updated until taken
+        using WarmMapKey = std::tuple<uint32 /*mapId*/, Difficulty, TeamId>;
+
         Map* FindMap_i(uint32 mapId, uint32 instanceId) const;
 
         Map* CreateWorldMap(uint32 mapId, uint32 instanceId);
         InstanceMap* CreateInstance(uint32 mapId, uint32 instanceId, InstanceSave* save, Difficulty difficulty, TeamId team);
+        // split for the warm pool, only the constructor registers the map with the global managers
+        InstanceMap* ConstructInstance(uint32 mapId, uint32 instanceId, bool hasSave, Difficulty difficulty, TeamId team);
+        static void LoadInstance(InstanceMap* map, bool loadData);
         BattlegroundMap* CreateBattleground(uint32 mapId, uint32 instanceId, Battleground* bg);
 
+        struct WarmMapJob
+        {
+            WarmMapKey Key;
+            Map* WarmMap = nullptr;
+            std::atomic<bool> Ready = false;                // set by the executor job once the map is loaded
+        };
+
+        Map* TakeWarmMap(WarmMapKey const& key);
+        Map* ConstructWarmMap(WarmMapKey const& key, uint32 instanceId);
+        static void LoadWarmMap(Map* map);
+        void RefillWarmMaps();
+
         bool DestroyMap(Map* map);
 
         mutable std::shared_mutex _mapsLock;
@@ -148,6 +179,12 @@ class TC_GAME_API MapManager
         std::unique_ptr<InstanceIds> _freeInstanceIds;
         uint32 _nextInstanceId;
         MapUpdater m_updater;
+        std::vector<std::pair<Map*, uint32>> _updatedMaps;  // maps updated this tick with their diff
+        TimerWheel<HibernationTimer> _hibernationWheel;
+
+        std::unordered_set<uint32> _warmMapIds;
+        std::map<WarmMapKey, std::vector<Map*>> _warmMaps;  // keys are added by the first request for a configured map id
+        std::shared_ptr<WarmMapJob> _warmMapJob;           // map being loaded in the background, one at a time
 
         // atomic op counter for active scripts amount
         std::atomic<std::size_t> _scheduledScripts;
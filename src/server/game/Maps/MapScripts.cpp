@@ -32,6 +32,9 @@
 /// Put scripts in the execution queue
 void Map::ScriptsStart(std::map<uint32, std::multimap<uint32, ScriptInfo>> const& scripts, uint32 id, Object* source, Object* target)
 {
+    RegionGuard guard(this);
+    RequestWakeUp();
+
     ///- Find the script map
     ScriptMapMap::const_iterator s = scripts.find(id);
     if (s == scripts.end())
@@ -70,6 +73,9 @@ void Map::ScriptsStart(std::map<uint32, std::multimap<uint32, ScriptInfo>> const
 
 void Map::ScriptCommandStart(ScriptInfo const& script, uint32 delay, Object* source, Object* target)
 {
+    RegionGuard guard(this);
+    RequestWakeUp();
+
     // NOTE: script record _must_ exist until command executed
 
     // prepare static data
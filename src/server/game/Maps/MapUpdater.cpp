@@ -16,8 +16,13 @@
 */
 
 #include "MapUpdater.h"
+#include "Log.h"
 #include "Map.h"
-
+#include "Metric.h"
+#include "StringFormat.h"
+#include "WorkStealingExecutor.h"
+#include <algorithm>
+#include <chrono>
 #include <mutex>
 
 
@@ -25,92 +30,112 @@ class MapUpdateRequest
 {
     private:
 
-        Map& m_map;
-        MapUpdater& m_updater;
+        Map* m_map;
+        MapUpdater* m_updater;
         uint32 m_diff;
+        bool m_delayedUpdate;
 
     public:
 
-        MapUpdateRequest(Map& m, MapUpdater& u, uint32 d)
-            : m_map(m), m_updater(u), m_diff(d)
+        MapUpdateRequest(Map& m, MapUpdater& u, uint32 d, bool delayedUpdate)
+            : m_map(&m), m_updater(&u), m_diff(d), m_delayedUpdate(delayedUpdate)
         {
         }
 
+        Map& GetMap() const { return *m_map; }
+
         void call()
         {
-            m_map.Update (m_diff);
-            m_updater.update_finished();
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            m_map->Update (m_diff);
+            uint32 cost = uint32(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+            m_map->RecordUpdateCost(cost);
+            TC_METRIC_VALUE(Trinity::StringFormat("map_update_time,map_id=%u,instance_id=%u", m_map->GetId(), m_map->GetInstanceId()), cost);
+            if (m_delayedUpdate)
+                m_map->DelayedUpdate(m_diff);
+            m_updater->update_finished(*m_map, cost);
         }
 };
 
+MapUpdater::MapUpdater() : pending_requests(0), _slowestMap(nullptr), _slowestMapCost(0) { }
+
+MapUpdater::~MapUpdater() = default;
+
 void MapUpdater::activate(size_t num_threads)
 {
-    for (size_t i = 0; i < num_threads; ++i)
-    {
-        _workerThreads.push_back(std::thread(&MapUpdater::WorkerThread, this));
-    }
+    _executor = std::make_unique<Trinity::WorkStealingExecutor>(num_threads);
 }
 
 void MapUpdater::deactivate()
 {
-    _cancelationToken = true;
-
     wait();
 
-    _queue.Cancel();
-
-    for (auto& thread : _workerThreads)
-    {
-        thread.join();
-    }
+    _executor->Join();
+    _executor.reset();
 }
 
 void MapUpdater::wait()
 {
+    dispatch_scheduled();
+
     std::unique_lock<std::mutex> lock(_lock);
 
     while (pending_requests > 0)
         _condition.wait(lock);
 
+    if (_slowestMap)
+    {
+        TC_LOG_DEBUG("maps", "MapUpdater: slowest map this tick was %u (instance %u) with %u us, average %u us",
+            _slowestMap->GetId(), _slowestMap->GetInstanceId(), _slowestMapCost, _slowestMap->GetAverageUpdateCost());
+        TC_METRIC_VALUE("map_update_slowest", _slowestMapCost);
+
+        _slowestMap = nullptr;
+        _slowestMapCost = 0;
+    }
+
+    // requests are kept by value, the storage is reused next tick
+    _requests.clear();
+
     lock.unlock();
 }
 
-void MapUpdater::schedule_update(Map& map, uint32 diff)
+void MapUpdater::schedule_update(Map& map, uint32 diff, bool delayedUpdate /*= false*/)
 {
     std::lock_guard<std::mutex> lock(_lock);
 
     ++pending_requests;
 
-    _queue.Push(new MapUpdateRequest(map, *this, diff));
+    _requests.emplace_back(map, *this, diff, delayedUpdate);
+}
+
+void MapUpdater::dispatch_scheduled()
+{
+    // longest job first, estimates are stable here since none of these maps is updating
+    std::stable_sort(_requests.begin(), _requests.end(), [](MapUpdateRequest const& left, MapUpdateRequest const& right)
+    {
+        return left.GetMap().GetEstimatedUpdateCost() > right.GetMap().GetEstimatedUpdateCost();
+    });
+
+    for (MapUpdateRequest& request : _requests)
+        _executor->Post([request = &request]() { request->call(); });
 }
 
 bool MapUpdater::activated()
 {
-    return _workerThreads.size() > 0;
+    return _executor != nullptr;
 }
 
-void MapUpdater::update_finished()
+void MapUpdater::update_finished(Map const& map, uint32 cost)
 {
     std::lock_guard<std::mutex> lock(_lock);
 
     --pending_requests;
 
-    _condition.notify_all();
-}
-
-void MapUpdater::WorkerThread()
-{
-    while (1)
+    if (cost >= _slowestMapCost)
     {
-        MapUpdateRequest* request = nullptr;
-
-        _queue.WaitAndPop(request);
-
-        if (_cancelationToken)
-            return;
-
-        request->call();
-
-        delete request;
+        _slowestMap = &map;
+        _slowestMapCost = cost;
     }
+
+    _condition.notify_all();
 }
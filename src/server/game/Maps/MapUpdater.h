@@ -19,10 +19,15 @@
 #define _MAP_UPDATER_H_INCLUDED
 
 #include "Define.h"
-#include <mutex>
-#include <thread>
 #include <condition_variable>
-#include "ProducerConsumerQueue.h"
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Trinity
+{
+    class WorkStealingExecutor;
+}
 
 class MapUpdateRequest;
 class Map;
@@ -31,12 +36,15 @@ class TC_GAME_API MapUpdater
 {
     public:
 
-        MapUpdater() : _cancelationToken(false), pending_requests(0) {}
-        ~MapUpdater() { };
+        MapUpdater();
+        ~MapUpdater();
 
         friend class MapUpdateRequest;
 
-        void schedule_update(Map& map, uint32 diff);
+        // requests are held back until wait() and then dispatched most expensive map first,
+        // so a large raid or continent scheduled last does not leave the tick waiting on it alone
+        // with delayedUpdate the map's DelayedUpdate runs on the same worker as soon as its Update is done
+        void schedule_update(Map& map, uint32 diff, bool delayedUpdate = false);
 
         void wait();
 
@@ -46,20 +54,24 @@ class TC_GAME_API MapUpdater
 
         bool activated();
 
-    private:
+        // shared by all parallel map work (map updates, grid regions) so it never oversubscribes the box
+        Trinity::WorkStealingExecutor* GetExecutor() { return _executor.get(); }
 
-        ProducerConsumerQueue<MapUpdateRequest*> _queue;
+    private:
 
-        std::vector<std::thread> _workerThreads;
-        std::atomic<bool> _cancelationToken;
+        std::unique_ptr<Trinity::WorkStealingExecutor> _executor;
+        std::vector<MapUpdateRequest> _requests;
 
         std::mutex _lock;
         std::condition_variable _condition;
         size_t pending_requests;
 
-        void update_finished();
+        Map const* _slowestMap;
+        uint32 _slowestMapCost;
+
+        void dispatch_scheduled();
 
-        void WorkerThread();
+        void update_finished(Map const& map, uint32 cost);
 };
 
 #endif //_MAP_UPDATER_H_INCLUDED
@@ -32,6 +32,11 @@
 #include "World.h"
 #include <G3D/g3dmath.h>
 
+TerrainGridPreload::TerrainGridPreload() = default;
+TerrainGridPreload::TerrainGridPreload(TerrainGridPreload&&) noexcept = default;
+TerrainGridPreload& TerrainGridPreload::operator=(TerrainGridPreload&&) noexcept = default;
+TerrainGridPreload::~TerrainGridPreload() = default;
+
 TerrainInfo::TerrainInfo(uint32 mapId) : _mapId(mapId), _parentTerrain(nullptr), _cleanupTimer(randtime(CleanupInterval / 2, CleanupInterval).count())
 {
 }
@@ -163,6 +168,36 @@ void TerrainInfo::LoadMapAndVMap(int32 gx, int32 gy)
     LoadMapAndVMapImpl(gx, gy);
 }
 
+TerrainGridPreload TerrainInfo::ReadGridMaps(int32 gx, int32 gy) const
+{
+    TerrainGridPreload preload;
+
+    // missing files are told by the load result, _gridFileExists may be written by the map thread meanwhile
+    std::string fileName = Trinity::StringFormat("%smaps/%03u%02u%02u.map", sWorld->GetDataPath().c_str(), GetId(), gx, gy);
+    std::unique_ptr<GridMap> gridMap = std::make_unique<GridMap>();
+    if (gridMap->loadData(fileName.c_str()) == GridMap::LoadResult::Ok)
+        preload.Grid = std::move(gridMap);
+
+    preload.ChildTerrain.reserve(_childTerrain.size());
+    for (std::shared_ptr<TerrainInfo> const& childTerrain : _childTerrain)
+        preload.ChildTerrain.push_back(childTerrain->ReadGridMaps(gx, gy));
+
+    return preload;
+}
+
+void TerrainInfo::AddPreloadedGridMaps(int32 gx, int32 gy, TerrainGridPreload&& preload)
+{
+    std::lock_guard<std::mutex> lock(_loadMutex);
+    if (_loadedGrids[GetBitsetIndex(gx, gy)])
+        return;
+
+    if (preload.Grid && !_gridMap[gx][gy])
+        _gridMap[gx][gy] = std::move(preload.Grid);
+
+    for (std::size_t i = 0; i < _childTerrain.size() && i < preload.ChildTerrain.size(); ++i)
+        _childTerrain[i]->AddPreloadedGridMaps(gx, gy, std::move(preload.ChildTerrain[i]));
+}
+
 void TerrainInfo::LoadMMapInstance(uint32 mapId, uint32 instanceId)
 {
     LoadMMapInstanceImpl(mapId, instanceId);
@@ -312,6 +347,7 @@ void TerrainInfo::CleanUpGrids(uint32 diff)
         return;
 
     // delete those GridMap objects which have refcount = 0
+    std::lock_guard<std::mutex> lock(_loadMutex);
     for (int32 x = 0; x < MAX_NUMBER_OF_GRIDS; ++x)
         for (int32 y = 0; y < MAX_NUMBER_OF_GRIDS; ++y)
             if (_loadedGrids[GetBitsetIndex(x, y)] && !_referenceCountFromMap[x][y])
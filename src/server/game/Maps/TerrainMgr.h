@@ -35,6 +35,18 @@ class DynamicMapTree;
 class GridMap;
 class PhaseShift;
 
+// map files of one grid of a terrain and its child terrains, read without touching the terrain
+struct TC_GAME_API TerrainGridPreload
+{
+    TerrainGridPreload();
+    TerrainGridPreload(TerrainGridPreload&&) noexcept;
+    TerrainGridPreload& operator=(TerrainGridPreload&&) noexcept;
+    ~TerrainGridPreload();
+
+    std::unique_ptr<GridMap> Grid;
+    std::vector<TerrainGridPreload> ChildTerrain;   // in the order of the child terrains
+};
+
 class TC_GAME_API TerrainInfo
 {
 public:
@@ -59,6 +71,12 @@ public:
     void LoadMapAndVMap(int32 gx, int32 gy);
     void LoadMMapInstance(uint32 mapId, uint32 instanceId);
 
+    // Reads the map files of a grid on any thread. vmap and mmap tiles are queried unlocked by map threads,
+    // so those are only loaded by LoadMapAndVMap on the map thread
+    TerrainGridPreload ReadGridMaps(int32 gx, int32 gy) const;
+    // Hands map files of ReadGridMaps to a grid that is about to be loaded with LoadMapAndVMap
+    void AddPreloadedGridMaps(int32 gx, int32 gy, TerrainGridPreload&& preload);
+
 private:
     void LoadMapAndVMapImpl(int32 gx, int32 gy);
     void LoadMMapInstanceImpl(uint32 mapId, uint32 instanceId);
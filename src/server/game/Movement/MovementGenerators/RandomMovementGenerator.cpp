@@ -192,7 +192,13 @@ bool RandomMovementGenerator<Creature>::DoUpdate(Creature* owner, uint32 diff)
 
     _timer.Update(diff);
     if (!_interrupt && _timer.Passed() && owner->movespline->Finalized())
-        SetRandomLocation(owner);
+    {
+        // nobody close enough to tell, save the path and the spline packets until a player comes near
+        if (owner->IsFarFromPlayers())
+            _timer.Reset(urand(4, 10) * IN_MILLISECONDS);
+        else
+            SetRandomLocation(owner);
+    }
 
     return true;
 }
@@ -95,6 +95,17 @@ void PhaseShift::ClearPhases()
     CosmeticReferences = 0;
     DefaultReferences = 0;
     UpdateUnphasedFlag();
+    UpdateSignatures();
+}
+
+uint32 PhaseShift::GetSummary() const
+{
+    if (Phases.empty() || Flags.HasFlag(PhaseShiftFlags::AlwaysVisible | PhaseShiftFlags::Inverse | PhaseShiftFlags::Unphased))
+        return 0xFFFFFFFF;
+
+    // folding id % 64 gives id % 32
+    uint64 signature = NonCosmeticSignature | CosmeticSignature | PersonalSignature;
+    return uint32(signature) | uint32(signature >> 32);
 }
 
 bool PhaseShift::CanSee(PhaseShift const& other) const
@@ -112,6 +123,17 @@ bool PhaseShift::CanSee(PhaseShift const& other) const
 
     if (!Flags.HasFlag(PhaseShiftFlags::Inverse) && !other.Flags.HasFlag(PhaseShiftFlags::Inverse))
     {
+        // phases that could pass the check below, no shared bit means no shared phase.
+        // Different ids can share a bit so a match still has to be confirmed
+        uint64 candidates = NonCosmeticSignature;
+        if (excludePhasesWithFlag != PhaseFlags::Cosmetic)
+            candidates |= CosmeticSignature;
+        if (PersonalGuid == other.PersonalGuid)
+            candidates |= PersonalSignature;
+
+        if (!(candidates & (other.NonCosmeticSignature | other.CosmeticSignature | other.PersonalSignature)))
+            return false;
+
         ObjectGuid ownerGuid = PersonalGuid;
         ObjectGuid otherPersonalGuid = other.PersonalGuid;
         return Trinity::Containers::Intersects(Phases.begin(), Phases.end(), other.Phases.begin(), other.Phases.end(),
@@ -148,6 +170,7 @@ bool PhaseShift::CanSee(PhaseShift const& other) const
 void PhaseShift::ModifyPhasesReferences(PhaseContainer::iterator itr, int32 references)
 {
     itr->References += references;
+    UpdateSignatures();
 
     if (!IsDbPhaseShift)
     {
@@ -176,3 +199,25 @@ void PhaseShift::UpdateUnphasedFlag()
     else
         Flags |= unphasedFlag;
 }
+
+void PhaseShift::UpdateSignatures()
+{
+    NonCosmeticSignature = 0;
+    CosmeticSignature = 0;
+    PersonalSignature = 0;
+
+    // phases are about to be erased when their last reference is gone
+    for (PhaseRef const& phaseRef : Phases)
+    {
+        if (phaseRef.References <= 0)
+            continue;
+
+        uint64 bit = UI64LIT(1) << (phaseRef.Id % 64);
+        if (phaseRef.Flags.HasFlag(PhaseFlags::Personal))
+            PersonalSignature |= bit;
+        else if (phaseRef.Flags.HasFlag(PhaseFlags::Cosmetic))
+            CosmeticSignature |= bit;
+        else
+            NonCosmeticSignature |= bit;
+    }
+}
@@ -85,7 +85,8 @@ public:
     typedef std::map<uint32, VisibleMapIdRef> VisibleMapIdContainer;
     typedef std::map<uint32, UiMapPhaseIdRef> UiMapPhaseIdContainer;
 
-    PhaseShift() : Flags(PhaseShiftFlags::Unphased), NonCosmeticReferences(0), CosmeticReferences(0), DefaultReferences(0), IsDbPhaseShift(false) { }
+    PhaseShift() : Flags(PhaseShiftFlags::Unphased), NonCosmeticReferences(0), CosmeticReferences(0), DefaultReferences(0),
+        NonCosmeticSignature(0), CosmeticSignature(0), PersonalSignature(0), IsDbPhaseShift(false) { }
 
     bool AddPhase(uint32 phaseId, PhaseFlags flags, std::vector<Condition*> const* areaConditions, int32 references = 1);
     EraseResult<PhaseContainer> RemovePhase(uint32 phaseId);
@@ -107,6 +108,10 @@ public:
 
     bool CanSee(PhaseShift const& other) const;
 
+    // One bit per phase id modulo 32, all bits when flags may make phases irrelevant.
+    // Two shifts with disjoint summaries can never see each other.
+    uint32 GetSummary() const;
+
 protected:
     friend class PhasingHandler;
 
@@ -118,9 +123,16 @@ protected:
 
     void ModifyPhasesReferences(PhaseContainer::iterator itr, int32 references);
     void UpdateUnphasedFlag();
+    void UpdateSignatures();
     int32 NonCosmeticReferences;
     int32 CosmeticReferences;
     int32 DefaultReferences;
+
+    // One bit per referenced phase id modulo 64, split by how CanSee treats the phase.
+    // Personal phases only go to PersonalSignature, cosmetic ones that are not personal to CosmeticSignature
+    uint64 NonCosmeticSignature;
+    uint64 CosmeticSignature;
+    uint64 PersonalSignature;
     bool IsDbPhaseShift;
 };
 
@@ -16,6 +16,7 @@
  */
 
 #include "PhasingHandler.h"
+#include "CellSpatialIndex.h"
 #include "Chat.h"
 #include "ConditionMgr.h"
 #include "Creature.h"
@@ -185,12 +186,14 @@ void PhasingHandler::ResetPhaseShift(WorldObject* object)
 {
     object->GetPhaseShift().Clear();
     object->GetSuppressedPhaseShift().Clear();
+    CellSpatialIndex::Update(object);
 }
 
 void PhasingHandler::InheritPhaseShift(WorldObject* target, WorldObject const* source)
 {
     target->GetPhaseShift() = source->GetPhaseShift();
     target->GetSuppressedPhaseShift() = source->GetSuppressedPhaseShift();
+    CellSpatialIndex::Update(target);
 }
 
 void PhasingHandler::OnMapChange(WorldObject* object)
@@ -563,6 +566,9 @@ std::string PhasingHandler::FormatPhases(PhaseShift const& phaseShift)
 
 void PhasingHandler::UpdateVisibilityIfNeeded(WorldObject* object, bool updateVisibility, bool changed)
 {
+    if (changed)
+        CellSpatialIndex::Update(object);
+
     if (changed && object->IsInWorld())
     {
         if (Player* player = object->ToPlayer())
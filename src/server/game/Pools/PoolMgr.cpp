@@ -914,6 +914,9 @@ bool PoolMgr::CheckPool(uint32 pool_id) const
 template<typename T>
 void PoolMgr::UpdatePool(SpawnedPoolData& spawnedPoolData, uint32 pool_id, uint32 db_guid_or_pool_id)
 {
+    // despawning pooled objects can be triggered from a parallel region update
+    Map::RegionGuard guard(spawnedPoolData.GetMap());
+
     if (uint32 motherpoolid = IsPartOfAPool<Pool>(pool_id))
         SpawnPool<Pool>(spawnedPoolData, motherpoolid, pool_id);
     else
@@ -29,22 +29,22 @@ class WorldPacket : public ByteBuffer
 {
     public:
                                                             // just container for later use
-        WorldPacket() : ByteBuffer(0), m_opcode(UNKNOWN_OPCODE), _connection(CONNECTION_TYPE_DEFAULT), _compressionStream(nullptr)
+        WorldPacket() : ByteBuffer(0), m_opcode(UNKNOWN_OPCODE), _connection(CONNECTION_TYPE_DEFAULT), _compressionStream(nullptr), _compressible(true)
         {
         }
 
         WorldPacket(uint16 opcode, size_t res = 200, ConnectionType connection = CONNECTION_TYPE_DEFAULT) : ByteBuffer(res),
-            m_opcode(opcode), _connection(connection), _compressionStream(nullptr) { }
+            m_opcode(opcode), _connection(connection), _compressionStream(nullptr), _compressible(true) { }
 
-        WorldPacket(WorldPacket&& packet) noexcept : ByteBuffer(std::move(packet)), m_opcode(packet.m_opcode), _connection(packet._connection), _compressionStream(nullptr)
+        WorldPacket(WorldPacket&& packet) noexcept : ByteBuffer(std::move(packet)), m_opcode(packet.m_opcode), _connection(packet._connection), _compressionStream(nullptr), _compressible(packet._compressible)
         {
         }
 
-        WorldPacket(WorldPacket&& packet, std::chrono::steady_clock::time_point receivedTime) : ByteBuffer(std::move(packet)), m_opcode(packet.m_opcode), _connection(packet._connection), _compressionStream(nullptr), m_receivedTime(receivedTime)
+        WorldPacket(WorldPacket&& packet, std::chrono::steady_clock::time_point receivedTime) : ByteBuffer(std::move(packet)), m_opcode(packet.m_opcode), _connection(packet._connection), _compressionStream(nullptr), _compressible(packet._compressible), m_receivedTime(receivedTime)
         {
         }
 
-        WorldPacket(WorldPacket const& right) : ByteBuffer(right), m_opcode(right.m_opcode), _connection(right._connection), _compressionStream(nullptr)
+        WorldPacket(WorldPacket const& right) : ByteBuffer(right), m_opcode(right.m_opcode), _connection(right._connection), _compressionStream(nullptr), _compressible(right._compressible)
         {
         }
 
@@ -54,6 +54,7 @@ class WorldPacket : public ByteBuffer
             {
                 m_opcode = right.m_opcode;
                 _connection = right._connection;
+                _compressible = right._compressible;
                 ByteBuffer::operator=(right);
             }
 
@@ -66,13 +67,14 @@ class WorldPacket : public ByteBuffer
             {
                 m_opcode = right.m_opcode;
                 _connection = right._connection;
+                _compressible = right._compressible;
                 ByteBuffer::operator=(std::move(right));
             }
 
             return *this;
         }
 
-        WorldPacket(uint16 opcode, MessageBuffer&& buffer, ConnectionType connection) : ByteBuffer(std::move(buffer)), m_opcode(opcode), _connection(connection), _compressionStream(nullptr)
+        WorldPacket(uint16 opcode, MessageBuffer&& buffer, ConnectionType connection) : ByteBuffer(std::move(buffer)), m_opcode(opcode), _connection(connection), _compressionStream(nullptr), _compressible(true)
         {
         }
 
@@ -82,6 +84,7 @@ class WorldPacket : public ByteBuffer
             _storage.reserve(newres);
             m_opcode = opcode;
             _connection = connection;
+            _compressible = true;
         }
 
         uint16 GetOpcode() const { return m_opcode; }
@@ -89,6 +92,9 @@ class WorldPacket : public ByteBuffer
         bool IsCompressed() const { return (m_opcode & COMPRESSED_OPCODE_MASK) != 0; }
         void Compress(z_stream_s* compressionStream);
         void Compress(z_stream_s* compressionStream, WorldPacket const* source);
+        // hint of the packet builder, packets known to compress poorly are sent as they are
+        bool IsCompressible() const { return _compressible; }
+        void SetCompressible(bool compressible) { _compressible = compressible; }
 
         ConnectionType GetConnection() const { return _connection; }
 
@@ -100,6 +106,7 @@ class WorldPacket : public ByteBuffer
         ConnectionType _connection;
         void Compress(void* dst, uint32 *dst_size, const void* src, int src_size);
         z_stream_s* _compressionStream;
+        bool _compressible;
         std::chrono::steady_clock::time_point m_receivedTime; // only set for a specific set of opcodes, for performance reasons.
 };
 
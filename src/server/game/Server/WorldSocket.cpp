@@ -193,7 +193,7 @@ bool WorldSocket::Update()
     MessageBuffer buffer(_sendBufferSize);
     while (_bufferQueue.Dequeue(queued))
     {
-        if (queued->size() > 0x400 && !queued->IsCompressed())
+        if (queued->size() > 0x400 && !queued->IsCompressed() && queued->IsCompressible())
             queued->Compress(_compressionStream);
 
         ServerPktHeader header(queued->size() + 2, queued->GetOpcode());
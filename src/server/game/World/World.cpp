@@ -716,6 +716,14 @@ void World::LoadConfigSettings(bool reload)
         TC_LOG_ERROR("server.loading", "Compression level (%i) must be in range 1..9. Using default compression level (1).", m_int_configs[CONFIG_COMPRESSION]);
         m_int_configs[CONFIG_COMPRESSION] = 1;
     }
+    m_bool_configs[CONFIG_COMPRESSION_SKIP_VALUES_UPDATES] = sConfigMgr->GetBoolDefault("Compression.SkipValuesUpdates", false);
+
+    m_int_configs[CONFIG_UPDATE_OBJECT_MAX_PACKET_SIZE] = sConfigMgr->GetIntDefault("UpdateObject.MaxPacketSize", 0x10000);
+    if (m_int_configs[CONFIG_UPDATE_OBJECT_MAX_PACKET_SIZE] && m_int_configs[CONFIG_UPDATE_OBJECT_MAX_PACKET_SIZE] < 0x1000)
+    {
+        TC_LOG_ERROR("server.loading", "UpdateObject.MaxPacketSize (%u) must be 0 or at least 4096. Using 4096 instead.", m_int_configs[CONFIG_UPDATE_OBJECT_MAX_PACKET_SIZE]);
+        m_int_configs[CONFIG_UPDATE_OBJECT_MAX_PACKET_SIZE] = 0x1000;
+    }
     m_bool_configs[CONFIG_ADDON_CHANNEL] = sConfigMgr->GetBoolDefault("AddonChannel", true);
     m_bool_configs[CONFIG_CLEAN_CHARACTER_DB] = sConfigMgr->GetBoolDefault("CleanCharacterDB", false);
     m_int_configs[CONFIG_PERSISTENT_CHARACTER_CLEAN_FLAGS] = sConfigMgr->GetIntDefault("PersistentCharacterCleanFlags", 0);
@@ -771,6 +779,8 @@ void World::LoadConfigSettings(bool reload)
     if (reload)
         sMapMgr->SetGridCleanUpDelay(m_int_configs[CONFIG_INTERVAL_GRIDCLEAN]);
 
+    m_int_configs[CONFIG_GRID_UNLOAD_RETAIN_BUDGET] = sConfigMgr->GetIntDefault("GridUnload.RetainBudget", 0);
+
     m_int_configs[CONFIG_INTERVAL_MAPUPDATE] = sConfigMgr->GetIntDefault("MapUpdateInterval", 10);
     if (m_int_configs[CONFIG_INTERVAL_MAPUPDATE] < MIN_MAP_UPDATE_DELAY)
     {
@@ -1064,6 +1074,7 @@ void World::LoadConfigSettings(bool reload)
     m_bool_configs[CONFIG_CAST_UNSTUCK] = sConfigMgr->GetBoolDefault("CastUnstuck", true);
     m_int_configs[CONFIG_INSTANCE_RESET_TIME_HOUR]  = sConfigMgr->GetIntDefault("Instance.ResetTimeHour", 4);
     m_int_configs[CONFIG_INSTANCE_UNLOAD_DELAY] = sConfigMgr->GetIntDefault("Instance.UnloadDelay", 30 * MINUTE * IN_MILLISECONDS);
+    m_int_configs[CONFIG_INSTANCE_WARM_POOL_SIZE] = sConfigMgr->GetIntDefault("Instance.WarmPool.Size", 0);
 
     m_int_configs[CONFIG_DAILY_QUEST_RESET_TIME_HOUR] = sConfigMgr->GetIntDefault("Quests.DailyResetTime", 3);
     if (m_int_configs[CONFIG_DAILY_QUEST_RESET_TIME_HOUR] > 23)
@@ -1112,6 +1123,7 @@ void World::LoadConfigSettings(bool reload)
     m_float_configs[CONFIG_CHANCE_OF_GM_SURVEY] = sConfigMgr->GetFloatDefault("GM.TicketSystem.ChanceOfGMSurvey", 50.0f);
 
     m_int_configs[CONFIG_GROUP_VISIBILITY] = sConfigMgr->GetIntDefault("Visibility.GroupMode", 1);
+    m_int_configs[CONFIG_VISIBILITY_ADAPTIVE_THRESHOLD] = sConfigMgr->GetIntDefault("Visibility.Adaptive.Threshold", 0);
 
     m_int_configs[CONFIG_MAIL_DELIVERY_DELAY] = sConfigMgr->GetIntDefault("MailDeliveryDelay", HOUR);
     m_int_configs[CONFIG_CLEAN_OLD_MAIL_TIME] = sConfigMgr->GetIntDefault("CleanOldMailTime", 4);
@@ -1372,6 +1384,13 @@ void World::LoadConfigSettings(bool reload)
         m_MaxVisibleDistanceInBGArenas = MAX_VISIBILITY_DISTANCE;
     }
 
+    m_float_configs[CONFIG_VISIBILITY_ADAPTIVE_MIN_DISTANCE] = sConfigMgr->GetFloatDefault("Visibility.Adaptive.MinDistance", 45.0f);
+    if (m_float_configs[CONFIG_VISIBILITY_ADAPTIVE_MIN_DISTANCE] < 45 * sWorld->getRate(RATE_CREATURE_AGGRO))
+    {
+        TC_LOG_ERROR("server.loading", "Visibility.Adaptive.MinDistance can't be less max aggro radius %f", 45 * sWorld->getRate(RATE_CREATURE_AGGRO));
+        m_float_configs[CONFIG_VISIBILITY_ADAPTIVE_MIN_DISTANCE] = 45 * sWorld->getRate(RATE_CREATURE_AGGRO);
+    }
+
     m_visibility_notify_periodOnContinents = sConfigMgr->GetIntDefault("Visibility.Notify.Period.OnContinents", DEFAULT_VISIBILITY_NOTIFY_PERIOD);
     m_visibility_notify_periodInInstances = sConfigMgr->GetIntDefault("Visibility.Notify.Period.InInstances",   DEFAULT_VISIBILITY_NOTIFY_PERIOD);
     m_visibility_notify_periodInBGArenas = sConfigMgr->GetIntDefault("Visibility.Notify.Period.InBGArenas",    DEFAULT_VISIBILITY_NOTIFY_PERIOD);
@@ -1506,6 +1525,17 @@ void World::LoadConfigSettings(bool reload)
     m_bool_configs[CONFIG_SHOW_MUTE_IN_WORLD] = sConfigMgr->GetBoolDefault("ShowMuteInWorld", false);
     m_bool_configs[CONFIG_SHOW_BAN_IN_WORLD] = sConfigMgr->GetBoolDefault("ShowBanInWorld", false);
     m_int_configs[CONFIG_NUMTHREADS] = sConfigMgr->GetIntDefault("MapUpdate.Threads", 1);
+    m_bool_configs[CONFIG_MAP_UPDATE_REGIONS] = sConfigMgr->GetBoolDefault("MapUpdate.Regions", false);
+    m_bool_configs[CONFIG_MAP_UPDATE_REGIONS_RELOCATION] = sConfigMgr->GetBoolDefault("MapUpdate.Regions.Relocation", true);
+    m_int_configs[CONFIG_MAP_UPDATE_REGION_MIN_PLAYERS] = sConfigMgr->GetIntDefault("MapUpdate.Regions.MinPlayers", 50);
+    m_bool_configs[CONFIG_MAP_UPDATE_PIPELINE_DELAYED] = sConfigMgr->GetBoolDefault("MapUpdate.PipelineDelayedUpdate", false);
+    m_bool_configs[CONFIG_MAP_HIBERNATION] = sConfigMgr->GetBoolDefault("MapUpdate.Hibernation", false);
+    m_int_configs[CONFIG_MAP_HIBERNATION_MAX_SLEEP] = sConfigMgr->GetIntDefault("MapUpdate.Hibernation.MaxSleep", 10000);
+    m_int_configs[CONFIG_MAP_UPDATE_FRAME_BUDGET] = sConfigMgr->GetIntDefault("MapUpdate.FrameBudget", 0);
+    m_int_configs[CONFIG_MAP_UPDATE_CREATURE_BUCKETS] = sConfigMgr->GetIntDefault("MapUpdate.CreatureBuckets", 1);
+    m_int_configs[CONFIG_MAP_UPDATE_FAR_CREATURES_INTERVAL] = sConfigMgr->GetIntDefault("MapUpdate.FarCreatures.Interval", 1);
+    m_float_configs[CONFIG_MAP_UPDATE_FAR_CREATURES_NEAR_RANGE] = sConfigMgr->GetFloatDefault("MapUpdate.FarCreatures.NearRange", 60.0f);
+    m_int_configs[CONFIG_MAP_GRID_PRELOAD_LOOKAHEAD] = sConfigMgr->GetIntDefault("MapUpdate.GridPreload.LookAhead", 0);
     m_int_configs[CONFIG_MAX_RESULTS_LOOKUP_COMMANDS] = sConfigMgr->GetIntDefault("Command.LookupMaxResults", 0);
 
     // Warden
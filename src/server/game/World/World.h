@@ -98,6 +98,7 @@ enum WorldTimers : uint8
 enum WorldBoolConfigs : uint8
 {
     CONFIG_DURABILITY_LOSS_IN_PVP = 0,
+    CONFIG_COMPRESSION_SKIP_VALUES_UPDATES,
     CONFIG_ADDON_CHANNEL,
     CONFIG_CLEAN_CHARACTER_DB,
     CONFIG_GRID_UNLOAD,
@@ -186,6 +187,10 @@ enum WorldBoolConfigs : uint8
     CONFIG_CHECK_GOBJECT_LOS,
     CONFIG_RESPAWN_DYNAMIC_ESCORTNPC,
     CONFIG_CACHE_DATA_QUERIES,
+    CONFIG_MAP_UPDATE_PIPELINE_DELAYED,
+    CONFIG_MAP_UPDATE_REGIONS,
+    CONFIG_MAP_UPDATE_REGIONS_RELOCATION,
+    CONFIG_MAP_HIBERNATION,
     BOOL_CONFIG_VALUE_COUNT
 };
 
@@ -211,14 +216,18 @@ enum WorldFloatConfigs : uint8
     CONFIG_ARENA_MATCHMAKER_RATING_MODIFIER,
     CONFIG_RESPAWN_DYNAMICRATE_CREATURE,
     CONFIG_RESPAWN_DYNAMICRATE_GAMEOBJECT,
+    CONFIG_VISIBILITY_ADAPTIVE_MIN_DISTANCE,
+    CONFIG_MAP_UPDATE_FAR_CREATURES_NEAR_RANGE,
     FLOAT_CONFIG_VALUE_COUNT
 };
 
 enum WorldIntConfigs : uint8
 {
     CONFIG_COMPRESSION = 0,
+    CONFIG_UPDATE_OBJECT_MAX_PACKET_SIZE,
     CONFIG_INTERVAL_SAVE,
     CONFIG_INTERVAL_GRIDCLEAN,
+    CONFIG_GRID_UNLOAD_RETAIN_BUDGET,
     CONFIG_INTERVAL_MAPUPDATE,
     CONFIG_INTERVAL_CHANGEWEATHER,
     CONFIG_INTERVAL_DISCONNECT_TOLERANCE,
@@ -262,6 +271,7 @@ enum WorldIntConfigs : uint8
     CONFIG_MAX_RECRUIT_A_FRIEND_BONUS_PLAYER_LEVEL_DIFFERENCE,
     CONFIG_INSTANCE_RESET_TIME_HOUR,
     CONFIG_INSTANCE_UNLOAD_DELAY,
+    CONFIG_INSTANCE_WARM_POOL_SIZE,
     CONFIG_DAILY_QUEST_RESET_TIME_HOUR,
     CONFIG_WEEKLY_QUEST_RESET_TIME_WDAY,
     CONFIG_MAX_PRIMARY_TRADE_SKILL,
@@ -280,6 +290,7 @@ enum WorldIntConfigs : uint8
     CONFIG_START_GM_LEVEL,
     CONFIG_FORCE_SHUTDOWN_THRESHOLD,
     CONFIG_GROUP_VISIBILITY,
+    CONFIG_VISIBILITY_ADAPTIVE_THRESHOLD,
     CONFIG_MAIL_DELIVERY_DELAY,
     CONFIG_CLEAN_OLD_MAIL_TIME,
     CONFIG_UPTIME_UPDATE,
@@ -341,6 +352,12 @@ enum WorldIntConfigs : uint8
     CONFIG_ENABLE_SINFO_LOGIN,
     CONFIG_PLAYER_ALLOW_COMMANDS,
     CONFIG_NUMTHREADS,
+    CONFIG_MAP_UPDATE_REGION_MIN_PLAYERS,
+    CONFIG_MAP_HIBERNATION_MAX_SLEEP,
+    CONFIG_MAP_UPDATE_FRAME_BUDGET,
+    CONFIG_MAP_UPDATE_CREATURE_BUCKETS,
+    CONFIG_MAP_UPDATE_FAR_CREATURES_INTERVAL,
+    CONFIG_MAP_GRID_PRELOAD_LOOKAHEAD,
     CONFIG_LOGDB_CLEARINTERVAL,
     CONFIG_LOGDB_CLEARTIME,
     CONFIG_CLIENTCACHE_VERSION,
@@ -536,6 +536,7 @@ class TC_SHARED_API ByteBuffer
         }
 
         size_t size() const { return _storage.size(); }
+        size_t capacity() const { return _storage.capacity(); }
         bool empty() const { return _storage.empty(); }
 
         void resize(size_t newsize)
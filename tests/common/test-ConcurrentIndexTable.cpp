@@ -0,0 +1,130 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "catch2/catch.hpp"
+#include "ConcurrentIndexTable.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <shared_mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using Trinity::ConcurrentIndexTable;
+
+TEST_CASE("Find and set entries", "[ConcurrentIndexTable]")
+{
+    ConcurrentIndexTable<int> table;
+    int first = 1, second = 2;
+
+    SECTION("Unset indexes are not found")
+    {
+        REQUIRE(table.Find(0) == nullptr);
+        REQUIRE(table.Find(0xFFFFFFFF) == nullptr);
+    }
+
+    SECTION("Set entries are found until cleared")
+    {
+        table.Set(5, &first);
+        table.Set(0xFFFFFFFF, &second);
+        REQUIRE(table.Find(5) == &first);
+        REQUIRE(table.Find(0xFFFFFFFF) == &second);
+        REQUIRE(table.Find(6) == nullptr);
+
+        table.Set(5, &second);
+        REQUIRE(table.Find(5) == &second);
+
+        table.Clear(5);
+        REQUIRE(table.Find(5) == nullptr);
+        REQUIRE(table.Find(0xFFFFFFFF) == &second);
+    }
+
+    SECTION("Concurrent writers of one chunk keep all entries")
+    {
+        std::vector<int> values(16);
+        std::vector<std::thread> writers;
+        for (uint32 i = 0; i < 4; ++i)
+            writers.emplace_back([&table, &values, i]()
+            {
+                for (uint32 index = i; index < 16; index += 4)
+                    table.Set(index, &values[index]);
+            });
+
+        for (std::thread& writer : writers)
+            writer.join();
+
+        for (uint32 index = 0; index < 16; ++index)
+            REQUIRE(table.Find(index) == &values[index]);
+    }
+}
+
+namespace
+{
+    template<typename Lookup>
+    double MeasureLookups(uint32 threads, uint32 players, Lookup const& lookup)
+    {
+        constexpr uint32 LookupsPerThread = 2000000;
+
+        std::atomic<std::size_t> found(0);
+        std::vector<std::thread> workers;
+        auto start = std::chrono::steady_clock::now();
+        for (uint32 i = 0; i < threads; ++i)
+            workers.emplace_back([&lookup, &found, players, i]()
+            {
+                std::size_t threadFound = 0;
+                for (uint32 n = 0; n < LookupsPerThread; ++n)
+                    threadFound += lookup((n * 7919 + i) % players) != nullptr;
+                found += threadFound;
+            });
+
+        for (std::thread& worker : workers)
+            worker.join();
+
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        REQUIRE(found == std::size_t(threads) * LookupsPerThread);
+        return threads * LookupsPerThread / elapsed.count() / 1e6;
+    }
+}
+
+// ./tests-common "[benchmark]" compares against the former shared_mutex guarded map of ObjectAccessor
+TEST_CASE("Lookup scaling with thread count", "[.][benchmark][ConcurrentIndexTable]")
+{
+    constexpr uint32 Players = 5000;
+    std::vector<int> values(Players);
+
+    ConcurrentIndexTable<int> table;
+    std::unordered_map<uint32, int*> map;
+    std::shared_mutex lock;
+    for (uint32 i = 0; i < Players; ++i)
+    {
+        table.Set(i, &values[i]);
+        map[i] = &values[i];
+    }
+
+    auto findInTable = [&table](uint32 index) { return table.Find(index); };
+    auto findInMap = [&map, &lock](uint32 index) -> int*
+    {
+        std::shared_lock<std::shared_mutex> guard(lock);
+        auto itr = map.find(index);
+        return itr != map.end() ? itr->second : nullptr;
+    };
+
+    std::printf("threads  shared_mutex map (M lookups/s)  index table (M lookups/s)\n");
+    for (uint32 threads = 1; threads <= std::max(1u, std::thread::hardware_concurrency()); threads *= 2)
+        std::printf("%7u  %31.1f  %25.1f\n", threads, MeasureLookups(threads, Players, findInMap), MeasureLookups(threads, Players, findInTable));
+}
@@ -0,0 +1,150 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "catch2/catch.hpp"
+#include "DirtyBitmap.h"
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+using Trinity::DirtyBitmap;
+
+namespace
+{
+    std::vector<uint32> GetSetBits(DirtyBitmap const& bitmap, uint32 limit = 0xFFFFFFFF)
+    {
+        std::vector<uint32> bits;
+        bitmap.ForEachSetBit([&bits](uint32 index) { bits.push_back(index); }, limit);
+        return bits;
+    }
+}
+
+TEST_CASE("Set, reset and visit bits", "[DirtyBitmap]")
+{
+    DirtyBitmap bitmap;
+    bitmap.Resize(300);
+
+    SECTION("New bitmap has no bits set")
+    {
+        REQUIRE_FALSE(bitmap.Any());
+        REQUIRE(GetSetBits(bitmap).empty());
+    }
+
+    SECTION("Set bits are visited once in ascending order")
+    {
+        for (uint32 index : { 299u, 5u, 64u, 63u, 130u, 5u })
+            bitmap.Set(index);
+
+        REQUIRE(bitmap.Test(64));
+        REQUIRE_FALSE(bitmap.Test(65));
+        REQUIRE(GetSetBits(bitmap) == std::vector<uint32>{ 5, 63, 64, 130, 299 });
+        REQUIRE(GetSetBits(bitmap, 130) == std::vector<uint32>{ 5, 63, 64 });
+    }
+
+    SECTION("Reset bits are not visited, emptied words can be set again")
+    {
+        bitmap.Set(70);
+        bitmap.Set(3);
+        bitmap.Reset(70);
+        bitmap.Reset(71);
+        REQUIRE(GetSetBits(bitmap) == std::vector<uint32>{ 3 });
+
+        bitmap.Set(71);
+        REQUIRE(GetSetBits(bitmap) == std::vector<uint32>{ 3, 71 });
+    }
+
+    SECTION("Clear resets every bit")
+    {
+        bitmap.Set(1);
+        bitmap.Set(200);
+        bitmap.Clear();
+        REQUIRE_FALSE(bitmap.Any());
+        REQUIRE_FALSE(bitmap.Test(200));
+
+        bitmap.Set(200);
+        REQUIRE(GetSetBits(bitmap) == std::vector<uint32>{ 200 });
+    }
+}
+
+namespace
+{
+    // the former UpdateMask, one byte per field
+    struct ByteMask
+    {
+        explicit ByteMask(uint32 count) : Bits(std::make_unique<uint8[]>(count)), Count(count) { std::fill_n(&Bits[0], Count, 0); }
+        void Set(uint32 index) { Bits[index] = 1; }
+        void Clear() { std::fill_n(&Bits[0], Count, 0); }
+
+        std::unique_ptr<uint8[]> Bits;
+        uint32 Count;
+    };
+
+    template<typename Build>
+    double MeasureBuilds(Build const& build)
+    {
+        constexpr uint32 Builds = 200000;
+
+        auto start = std::chrono::steady_clock::now();
+        for (uint32 i = 0; i < Builds; ++i)
+            build(i);
+
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count() / Builds;
+    }
+}
+
+// ./tests-common "[benchmark]" values update of two changed fields (e.g. health and power), field counts of Item, Unit and Player
+TEST_CASE("Changed field scan", "[.][benchmark][DirtyBitmap]")
+{
+    std::printf("fields  byte per field (ns/update)  dirty bitmap (ns/update)\n");
+    for (uint32 fieldCount : { 74u, 146u, 1384u })
+    {
+        std::vector<uint32> values(fieldCount, 1);
+        std::vector<uint32> packet;
+        packet.reserve(fieldCount);
+
+        ByteMask byteMask(fieldCount);
+        double byteTime = MeasureBuilds([&](uint32 i)
+        {
+            byteMask.Set(i % 32 + 8);
+            byteMask.Set(i % 32 + 40);
+            packet.clear();
+            for (uint32 index = 0; index < fieldCount; ++index)
+                if (byteMask.Bits[index])
+                    packet.push_back(values[index]);
+
+            byteMask.Clear();
+        });
+
+        REQUIRE(packet.size() == 2);
+
+        DirtyBitmap bitmap;
+        bitmap.Resize(fieldCount);
+        double bitmapTime = MeasureBuilds([&](uint32 i)
+        {
+            bitmap.Set(i % 32 + 8);
+            bitmap.Set(i % 32 + 40);
+            packet.clear();
+            bitmap.ForEachSetBit([&](uint32 index) { packet.push_back(values[index]); });
+            bitmap.Clear();
+        });
+
+        REQUIRE(packet.size() == 2);
+        std::printf("%6u  %26.1f  %24.1f\n", fieldCount, byteTime, bitmapTime);
+    }
+}
@@ -0,0 +1,66 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "catch2/catch.hpp"
+#include "ReusableBuffer.h"
+
+using Buffer = Trinity::ReusableBuffer<uint32, 4>;
+
+TEST_CASE("Lease and reuse buffers", "[ReusableBuffer]")
+{
+    SECTION("Released buffer is handed out again empty with its storage")
+    {
+        uint32 const* storage = nullptr;
+        {
+            Buffer buffer;
+            for (uint32 i = 0; i < 100; ++i)
+                buffer->push_back(i);
+            storage = buffer->data();
+        }
+
+        Buffer buffer;
+        REQUIRE(buffer->empty());
+        REQUIRE(buffer->capacity() >= 100);
+        REQUIRE(buffer->data() == storage);
+    }
+
+    SECTION("Nested leases own distinct buffers")
+    {
+        Buffer outer;
+        outer->push_back(1);
+        {
+            Buffer inner;
+            REQUIRE(inner->empty());
+            inner->push_back(2);
+            REQUIRE(&*inner != &*outer);
+        }
+
+        REQUIRE(outer->size() == 1);
+        REQUIRE(outer->front() == 1);
+    }
+
+    SECTION("Oversized buffers are not retained")
+    {
+        {
+            Buffer buffer;
+            buffer->resize(Buffer::MaxRetainedCapacity + 1);
+        }
+
+        Buffer buffer;
+        REQUIRE(buffer->capacity() <= Buffer::MaxRetainedCapacity);
+    }
+}
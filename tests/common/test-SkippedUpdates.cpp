@@ -0,0 +1,135 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "catch2/catch.hpp"
+#include "SkippedUpdates.h"
+#include <vector>
+
+using Trinity::SkippedUpdates;
+
+namespace
+{
+    // one visit of a cell updating its objects the way ObjectUpdater does, returns the diffs of the done updates
+    std::vector<uint32> Visit(std::vector<SkippedUpdates>& objects, uint32 period, uint32 diff)
+    {
+        std::vector<uint32> updates;
+        for (uint32 phase = 0; phase < objects.size(); ++phase)
+        {
+            if (objects[phase].Skip(phase, period, diff))
+                continue;
+
+            updates.push_back(objects[phase].Take(diff));
+        }
+        return updates;
+    }
+}
+
+TEST_CASE("Objects update once per period of visits", "[SkippedUpdates]")
+{
+    std::vector<SkippedUpdates> objects(8);
+
+    SECTION("Period of one never skips")
+    {
+        for (uint32 visit = 0; visit < 4; ++visit)
+            REQUIRE(Visit(objects, 1, 10) == std::vector<uint32>(8, 10));
+    }
+
+    SECTION("Phases spread the updates and every object gets the time of all its visits")
+    {
+        // first visits only update the objects whose phase comes up, with the time since the first visit
+        REQUIRE(Visit(objects, 4, 10).size() == 2);
+        REQUIRE(Visit(objects, 4, 10) == std::vector<uint32>{ 20, 20 });
+        REQUIRE(Visit(objects, 4, 10) == std::vector<uint32>{ 30, 30 });
+        REQUIRE(Visit(objects, 4, 10) == std::vector<uint32>{ 40, 40 });
+
+        for (uint32 visit = 0; visit < 8; ++visit)
+            REQUIRE(Visit(objects, 4, 10) == std::vector<uint32>{ 40, 40 });
+    }
+}
+
+TEST_CASE("Staggered cells with an even period", "[SkippedUpdates]")
+{
+    // a cell of the stagger level is only visited on the ticks of its parity, an even bucket
+    // count compared with the global tick would starve the objects of the other parity
+    uint32 const period = 4;
+    uint32 const tickDiff = 50;
+    std::vector<SkippedUpdates> objects(period * 2);
+    std::vector<uint32> lastUpdateTick(objects.size(), 0);
+    uint32 pending = 0;
+
+    for (uint32 tick = 0; tick < 64; ++tick)
+    {
+        pending += tickDiff;
+        if (tick & 1)
+            continue;
+
+        for (uint32 phase = 0; phase < objects.size(); ++phase)
+        {
+            if (objects[phase].Skip(phase, period, pending))
+            {
+                REQUIRE(tick - lastUpdateTick[phase] < 2 * period);
+                continue;
+            }
+
+            // a staggered visit covers two ticks, period visits cover twice as many
+            REQUIRE(objects[phase].Take(pending) <= 2 * period * tickDiff);
+            lastUpdateTick[phase] = tick;
+        }
+        pending = 0;
+    }
+
+    for (uint32 phase = 0; phase < objects.size(); ++phase)
+    {
+        REQUIRE(lastUpdateTick[phase] >= 64 - 2 * period);
+        REQUIRE(objects[phase].GetSkippedTime() < 2 * period * tickDiff);
+    }
+}
+
+TEST_CASE("Changing the period", "[SkippedUpdates]")
+{
+    SkippedUpdates object;
+    REQUIRE(object.Skip(3, 4, 10));
+    REQUIRE(object.Skip(3, 4, 10));
+
+    // the far interval takes over, skipped time is kept
+    REQUIRE(object.Skip(1, 2, 10));
+    REQUIRE_FALSE(object.Skip(1, 2, 10));
+    REQUIRE(object.Take(10) == 40);
+
+    // an object that could not skip is updated and counts from there
+    REQUIRE(object.Skip(1, 2, 10));
+    REQUIRE(object.Take(10) == 20);
+}
+
+TEST_CASE("Alternating near and far periods", "[SkippedUpdates]")
+{
+    // with an even far interval on staggered cells, an object switching between the bucket and the
+    // far period on every visit still updates within the longer period
+    SkippedUpdates object;
+    uint32 skipped = 0;
+    for (uint32 visit = 0; visit < 32; ++visit)
+    {
+        if (object.Skip(3, visit & 1 ? 4 : 2, 10))
+        {
+            REQUIRE(++skipped < 4);
+            continue;
+        }
+
+        REQUIRE(object.Take(10) == (skipped + 1) * 10);
+        skipped = 0;
+    }
+}
@@ -0,0 +1,78 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "catch2/catch.hpp"
+#include "TimerWheel.h"
+#include <vector>
+
+TEST_CASE("Expire timers", "[TimerWheel]")
+{
+    TimerWheel<uint32, 8> wheel(10);
+    std::vector<uint32> expired;
+    auto collect = [&expired](uint32 value) { expired.push_back(value); };
+
+    REQUIRE(wheel.Empty());
+
+    SECTION("Timer expires once its delay has passed")
+    {
+        wheel.Schedule(25, 1);
+        REQUIRE(wheel.Size() == 1);
+
+        wheel.Advance(20, collect);
+        REQUIRE(expired.empty());
+
+        wheel.Advance(10, collect);
+        REQUIRE(expired == std::vector<uint32>{ 1 });
+        REQUIRE(wheel.Empty());
+    }
+
+    SECTION("Timer further than one turn waits for the remaining turns")
+    {
+        wheel.Schedule(200, 2);
+
+        wheel.Advance(80, collect);
+        REQUIRE(expired.empty());
+
+        wheel.Advance(110, collect);
+        REQUIRE(expired.empty());
+
+        wheel.Advance(10, collect);
+        REQUIRE(expired == std::vector<uint32>{ 2 });
+    }
+
+    SECTION("Large advance expires every passed timer")
+    {
+        wheel.Schedule(5, 1);
+        wheel.Schedule(30, 2);
+        wheel.Schedule(500, 3);
+
+        wheel.Advance(100, collect);
+        REQUIRE(expired == std::vector<uint32>{ 1, 2 });
+        REQUIRE(wheel.Size() == 1);
+    }
+
+    SECTION("Expired timer can be scheduled again")
+    {
+        uint32 fired = 0;
+        wheel.Schedule(10, 1);
+        for (uint32 i = 0; i < 5; ++i)
+            wheel.Advance(10, [&wheel, &fired](uint32 value) { ++fired; wheel.Schedule(10, value); });
+
+        REQUIRE(fired == 5);
+        REQUIRE(wheel.Size() == 1);
+    }
+}
@@ -0,0 +1,112 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "catch2/catch.hpp"
+#include "WorkStealingExecutor.h"
+#include <atomic>
+#include <memory>
+#include <thread>
+
+using Trinity::ExecutorJob;
+using Trinity::TaskPriority;
+using Trinity::WorkStealingExecutor;
+
+TEST_CASE("ExecutorJob", "[WorkStealingExecutor]")
+{
+    SECTION("Empty job")
+    {
+        ExecutorJob job;
+        REQUIRE_FALSE(job);
+    }
+
+    SECTION("Moved job keeps its captures")
+    {
+        int calls = 0;
+        std::shared_ptr<int> value = std::make_shared<int>(5);
+        ExecutorJob job([&calls, value]() { calls += *value; });
+        REQUIRE(value.use_count() == 2);
+
+        ExecutorJob moved(std::move(job));
+        REQUIRE_FALSE(job);
+        REQUIRE(moved);
+        REQUIRE(value.use_count() == 2);
+
+        moved();
+        REQUIRE(calls == 5);
+
+        moved.Reset();
+        REQUIRE(value.use_count() == 1);
+    }
+}
+
+TEST_CASE("Run posted jobs", "[WorkStealingExecutor]")
+{
+    std::atomic<int> counter(0);
+
+    SECTION("Join runs every queued job")
+    {
+        WorkStealingExecutor executor(4);
+        for (int i = 0; i < 1000; ++i)
+            executor.Post([&counter]() { ++counter; }, i % 2 ? TaskPriority::High : TaskPriority::Normal);
+
+        executor.Join();
+        REQUIRE(counter == 1000);
+    }
+
+    SECTION("Jobs can wait on jobs they post")
+    {
+        WorkStealingExecutor executor(2);
+        std::atomic<int> finished(0);
+        for (int i = 0; i < 8; ++i)
+        {
+            executor.Post([&executor, &counter, &finished]()
+            {
+                std::atomic<int> children(0);
+                for (int j = 0; j < 16; ++j)
+                    executor.Post([&counter, &children]() { ++counter; ++children; }, TaskPriority::High);
+
+                executor.HelpUntil([&children]() { return children == 16; }, TaskPriority::High);
+                ++finished;
+            });
+        }
+
+        executor.HelpUntil([&finished]() { return finished == 8; });
+        REQUIRE(counter == 8 * 16);
+    }
+
+    SECTION("Calling thread only runs jobs of the requested priority")
+    {
+        WorkStealingExecutor executor(1);
+        std::atomic<bool> started(false);
+        std::atomic<bool> release(false);
+        executor.Post([&started, &release]() { started = true; while (!release) std::this_thread::yield(); });
+        while (!started)
+            std::this_thread::yield();
+
+        executor.Post([&counter]() { ++counter; });
+        REQUIRE_FALSE(executor.RunPendingJob(TaskPriority::High));
+        REQUIRE(executor.RunPendingJob(TaskPriority::Normal));
+        REQUIRE(counter == 1);
+
+        executor.Post([&counter]() { ++counter; }, TaskPriority::Low);
+        REQUIRE_FALSE(executor.RunPendingJob());
+        REQUIRE(executor.RunPendingJob(TaskPriority::Low));
+        REQUIRE(counter == 2);
+
+        release = true;
+    }
+}